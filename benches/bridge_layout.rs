@@ -0,0 +1,147 @@
+//! Measures converting struct records between guest and host layout with the
+//! bridge's precomputed layout plans, for batches of a few sizes.
+
+use criterion::*;
+use std::ffi::c_void;
+use std::mem;
+use std::os::raw::c_int;
+
+criterion_main!(benches);
+criterion_group!(benches, bench_bridge_layout);
+
+const BRIDGE_FIELD_SCALAR: c_int = 0;
+const BRIDGE_FIELD_PTR: c_int = 1;
+
+#[repr(C)]
+#[derive(Clone, Copy)]
+struct BridgeField {
+    kind: c_int,
+    guest_offset: u32,
+    host_offset: u32,
+    size: u32,
+}
+
+// Mirrors `bridge_layout` in src/commands/helper/helper.h.
+#[repr(C)]
+struct BridgeLayout {
+    guest_size: u32,
+    host_size: u32,
+    nptrs: u32,
+    nruns: u32,
+    ptr_guest: [u32; 16],
+    ptr_host: [u32; 16],
+    runs: [BridgeField; 16],
+    identity: c_int,
+    to_host: *const c_void,
+    to_guest: *const c_void,
+}
+
+#[link(name = "my-helpers")]
+extern "C" {
+    fn get_linear_memory(mem: *mut u8);
+    fn bridge_layout_init(
+        plan: *mut BridgeLayout,
+        fields: *const BridgeField,
+        nfields: c_int,
+        guest_size: u32,
+        host_size: u32,
+    ) -> c_int;
+    fn bridge_layout_to_host(
+        plan: *const BridgeLayout,
+        host: *mut c_void,
+        guest: *const c_void,
+        n: usize,
+    );
+    fn bridge_layout_to_guest(
+        plan: *const BridgeLayout,
+        guest: *mut c_void,
+        host: *const c_void,
+        n: usize,
+    );
+}
+
+/// `struct { char *name; int age; int id; char *email; }` against its wasm32
+/// layout, two pointers and a merged scalar run.
+fn plan() -> BridgeLayout {
+    let word = mem::size_of::<usize>() as u32;
+    let fields = [
+        BridgeField {
+            kind: BRIDGE_FIELD_PTR,
+            guest_offset: 0,
+            host_offset: 0,
+            size: 0,
+        },
+        BridgeField {
+            kind: BRIDGE_FIELD_SCALAR,
+            guest_offset: 4,
+            host_offset: word,
+            size: 4,
+        },
+        BridgeField {
+            kind: BRIDGE_FIELD_SCALAR,
+            guest_offset: 8,
+            host_offset: word + 4,
+            size: 4,
+        },
+        BridgeField {
+            kind: BRIDGE_FIELD_PTR,
+            guest_offset: 12,
+            host_offset: word + 8,
+            size: 0,
+        },
+    ];
+    let mut plan: BridgeLayout = unsafe { mem::zeroed() };
+    let ret = unsafe {
+        bridge_layout_init(
+            &mut plan,
+            fields.as_ptr(),
+            fields.len() as c_int,
+            16,
+            2 * word + 8,
+        )
+    };
+    assert_eq!(ret, 0);
+    plan
+}
+
+fn bench_bridge_layout(c: &mut Criterion) {
+    // Small batches show the per-call overhead, the large ones the vector
+    // kernels on arrays of the size bridged natives actually see.
+    let sizes = [1, 4, 16, 256, 10_000, 65_536];
+    let plan = plan();
+    // Record `i` points 64 bytes further in, keep every pointer in bounds.
+    let mut memory = vec![0u8; 64 * (65_536 + 1)];
+    unsafe { get_linear_memory(memory.as_mut_ptr()) };
+
+    let mut group = c.benchmark_group("bridge-layout");
+    for n in sizes {
+        let mut guest = vec![0u8; n * plan.guest_size as usize];
+        for (i, record) in guest.chunks_mut(16).enumerate() {
+            record[0..4].copy_from_slice(&(64 * i as u32).to_le_bytes());
+            record[12..16].copy_from_slice(&(64 * i as u32 + 32).to_le_bytes());
+        }
+        let mut host = vec![0u8; n * plan.host_size as usize];
+        group.throughput(Throughput::Elements(n as u64));
+        group.bench_with_input(BenchmarkId::new("to-host", n), &n, |b, &n| {
+            b.iter(|| unsafe {
+                bridge_layout_to_host(
+                    &plan,
+                    host.as_mut_ptr().cast(),
+                    black_box(guest.as_ptr()).cast(),
+                    n,
+                )
+            })
+        });
+        group.bench_with_input(BenchmarkId::new("to-guest", n), &n, |b, &n| {
+            b.iter(|| unsafe {
+                bridge_layout_to_guest(
+                    &plan,
+                    guest.as_mut_ptr().cast(),
+                    black_box(host.as_ptr()).cast(),
+                    n,
+                )
+            })
+        });
+    }
+    group.finish();
+}
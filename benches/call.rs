@@ -1,8 +1,10 @@
 use criterion::measurement::WallTime;
-use criterion::{criterion_group, criterion_main, BenchmarkGroup, Criterion};
+use criterion::{criterion_group, criterion_main, BenchmarkGroup, Criterion, Throughput};
 use std::fmt::Debug;
 use std::future::Future;
+use std::mem::MaybeUninit;
 use std::pin::Pin;
+use std::ptr;
 use std::task::{Context, Poll, RawWaker, RawWakerVTable, Waker};
 use std::time::Instant;
 use wasmtime::*;
@@ -12,6 +14,7 @@ criterion_group!(benches, measure_execution_time);
 
 fn measure_execution_time(c: &mut Criterion) {
     host_to_wasm(c);
+    host_to_wasm_batch(c);
     wasm_to_host(c);
 }
 
@@ -178,6 +181,111 @@ fn bench_host_to_wasm<Params, Results>(
     });
 }
 
+/// Benchmarks `wasmtime_func_call_batch` from the C API against making the
+/// same number of calls one at a time through `wasmtime_func_call`.
+fn host_to_wasm_batch(c: &mut Criterion) {
+    const BATCH: usize = 64;
+
+    let engine = capi::wasm_engine_new();
+    let mut store = capi::wasmtime_store_new(&engine, ptr::null_mut(), None);
+    let wasm = wat::parse_str(
+        r#"(module
+            (func (export "nop"))
+            (func (export "nop-params-and-results") (param i32 i64) (result f32)
+                f32.const 0)
+        )"#,
+    )
+    .unwrap();
+    let instance = unsafe {
+        let mut module = ptr::null_mut();
+        assert!(
+            capi::wasmtime_module_new(&engine, wasm.as_ptr(), wasm.len(), &mut module).is_none()
+        );
+        let mut instance = MaybeUninit::uninit();
+        let mut trap = ptr::null_mut();
+        assert!(capi::wasmtime_instance_new(
+            capi::wasmtime_store_context(&mut store),
+            &*module,
+            ptr::null(),
+            0,
+            &mut *instance.as_mut_ptr(),
+            &mut trap,
+        )
+        .is_none());
+        assert!(trap.is_null());
+        capi::wasmtime_module_delete(Box::from_raw(module));
+        instance.assume_init()
+    };
+
+    let mut group = c.benchmark_group("c-api/batch");
+    group.throughput(Throughput::Elements(BATCH as u64));
+    for (name, params, nresults) in [
+        ("nop", vec![], 0),
+        ("nop-params-and-results", vec![Val::I32(0), Val::I64(0)], 1),
+    ] {
+        let func = unsafe {
+            let mut item = MaybeUninit::uninit();
+            assert!(capi::wasmtime_instance_export_get(
+                capi::wasmtime_store_context(&mut store),
+                &instance,
+                name.as_ptr(),
+                name.len(),
+                &mut item,
+            ));
+            item.assume_init().of.func
+        };
+        let args = (0..BATCH)
+            .flat_map(|_| params.iter().cloned())
+            .map(capi::wasmtime_val_t::from_val)
+            .collect::<Vec<_>>();
+        let mut results = (0..BATCH * nresults)
+            .map(|_| MaybeUninit::uninit())
+            .collect::<Vec<_>>();
+        let nargs = params.len();
+
+        // The same `BATCH` calls made one at a time.
+        group.bench_function(&format!("untyped batch - {}", name), |b| {
+            b.iter(|| unsafe {
+                for i in 0..BATCH {
+                    let mut trap = ptr::null_mut();
+                    let err = capi::wasmtime_func_call(
+                        capi::wasmtime_store_context(&mut store),
+                        &func,
+                        args[i * nargs..].as_ptr(),
+                        nargs,
+                        results[i * nresults..].as_mut_ptr(),
+                        nresults,
+                        &mut trap,
+                    );
+                    assert!(err.is_none() && trap.is_null());
+                }
+            })
+        });
+
+        // One `wasmtime_func_call_batch` for all of them, which checks the
+        // argument types once and reuses a raw buffer across the calls.
+        group.bench_function(&format!("unchecked batch - {}", name), |b| {
+            b.iter(|| unsafe {
+                let mut trap_index = 0;
+                let mut trap = ptr::null_mut();
+                let err = capi::wasmtime_func_call_batch(
+                    capi::wasmtime_store_context(&mut store),
+                    &func,
+                    args.as_ptr(),
+                    nargs,
+                    results.as_mut_ptr(),
+                    nresults,
+                    BATCH,
+                    &mut trap_index,
+                    &mut trap,
+                );
+                assert!(err.is_none() && trap.is_null());
+            })
+        });
+    }
+    group.finish();
+}
+
 /// Benchmarks the overhead of calling the host from WebAssembly itself
 fn wasm_to_host(c: &mut Criterion) {
     let module = r#"(module
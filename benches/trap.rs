@@ -10,6 +10,7 @@ fn bench_traps(c: &mut Criterion) {
     bench_many_modules_registered_traps(c);
     bench_many_stack_frames_traps(c);
     bench_host_wasm_frames_traps(c);
+    bench_backtrace_capture_traps(c);
 }
 
 fn bench_multi_threaded_traps(c: &mut Criterion) {
@@ -220,6 +221,41 @@ fn bench_host_wasm_frames_traps(c: &mut Criterion) {
     group.finish()
 }
 
+#[allow(deprecated)]
+fn bench_backtrace_capture_traps(c: &mut Criterion) {
+    let mut group = c.benchmark_group("backtrace-capture-traps");
+
+    for (name, backtrace, lazy) in [
+        ("eager", true, false),
+        ("lazy", true, true),
+        ("disabled", false, false),
+    ] {
+        let mut config = Config::new();
+        config.wasm_backtrace(backtrace).wasm_backtrace_lazy(lazy);
+        let engine = Engine::new(&config).unwrap();
+        let module = module(&engine, 64).unwrap();
+
+        group.bench_function(BenchmarkId::from_parameter(name), |b| {
+            b.iter_custom(|iters| {
+                let mut store = Store::new(&engine, ());
+                let instance = Instance::new(&mut store, &module, &[]).unwrap();
+                let f = instance
+                    .get_typed_func::<(), (), _>(&mut store, "")
+                    .unwrap();
+
+                let start = std::time::Instant::now();
+                for _ in 0..iters {
+                    let trap = f.call(&mut store, ()).unwrap_err();
+                    assert!(trap.trap_code().is_some());
+                }
+                start.elapsed()
+            });
+        });
+    }
+
+    group.finish()
+}
+
 fn module(engine: &Engine, num_funcs: u64) -> Result<Module> {
     let mut wat = String::new();
     wat.push_str("(module\n");
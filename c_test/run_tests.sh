@@ -0,0 +1,17 @@
+# Builds every guest under tests/ that has a .expected file next to it and
+# checks what it prints when run through the bridge. Needs WASI_SYSROOT, like
+# build.sh.
+set -e
+cd "$(dirname "$0")"
+
+for expected in tests/*.c.expected; do
+    f=${expected%.expected}
+    sh build.sh ${f}
+    actual=$(cargo run --quiet -- run ${f}.wasm)
+    if [ "${actual}" != "$(cat ${expected})" ]; then
+        echo "FAIL ${f}"
+        echo "${actual}"
+        exit 1
+    fi
+    echo "ok ${f}"
+done
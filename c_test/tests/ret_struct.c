@@ -0,0 +1,14 @@
+#include "../pub.h"
+// 结构体作为返回值时, wasm 会把它变成第一个 i32 参数 (返回值所在的指针)
+typedef struct {
+    char *name;
+    int age;
+} Stu;
+
+extern Stu new_stu(char *name, int age);
+
+int main() {
+    Stu s = new_stu("student", 21);
+    printf("name: %s\n", s.name);
+    printf("age: %d\n", s.age);
+}
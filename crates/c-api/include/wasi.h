@@ -100,6 +100,18 @@ WASI_API_EXTERN bool wasi_config_set_stdin_file(wasi_config_t* config, const cha
  */
 WASI_API_EXTERN void wasi_config_inherit_stdin(wasi_config_t* config);
 
+/**
+ * \brief Configures standard input to read from the specified bytes.
+ *
+ * By default WASI programs have no stdin, but this configures the contents of
+ * `binary` to be what the program reads from stdin, without going through
+ * the filesystem.
+ *
+ * This function takes ownership of the contents of `binary`, leaving it
+ * empty.
+ */
+WASI_API_EXTERN void wasi_config_set_stdin_bytes(wasi_config_t* config, wasm_byte_vec_t* binary);
+
 /**
  * \brief Configures standard output to be written to the specified file.
  *
@@ -134,6 +146,77 @@ WASI_API_EXTERN bool wasi_config_set_stderr_file(wasi_config_t* config, const ch
  */
 WASI_API_EXTERN void wasi_config_inherit_stderr(wasi_config_t* config);
 
+/**
+ * \typedef wasi_output_buffer_t
+ * \brief Convenience alias for #wasi_output_buffer_t
+ *
+ * \struct wasi_output_buffer_t
+ * \brief A growable in-memory buffer that captures a WASI output stream.
+ *
+ * A buffer is attached to a configuration with #wasi_config_set_stdout_buffer
+ * or #wasi_config_set_stderr_buffer. Everything the program writes to that
+ * stream is appended to the buffer, and can be retrieved with
+ * #wasi_output_buffer_take while or after the program runs. The buffer
+ * stays usable after the configuration or store using it is deleted.
+ *
+ * \fn void wasi_output_buffer_delete(wasi_output_buffer_t *);
+ * \brief Deletes an output buffer.
+ */
+WASI_DECLARE_OWN(output_buffer)
+
+/**
+ * \brief Creates a new, empty output buffer.
+ */
+WASI_API_EXTERN own wasi_output_buffer_t* wasi_output_buffer_new(void);
+
+/**
+ * \brief Moves everything written to `buffer` so far into `out`, leaving the
+ * buffer empty.
+ *
+ * The caller owns `out` afterwards and must delete it with
+ * #wasm_byte_vec_delete.
+ */
+WASI_API_EXTERN void wasi_output_buffer_take(const wasi_output_buffer_t* buffer, wasm_byte_vec_t* out);
+
+/**
+ * \brief Configures standard output to be captured in `buffer`.
+ *
+ * This function doesn't take ownership of `buffer`.
+ */
+WASI_API_EXTERN void wasi_config_set_stdout_buffer(wasi_config_t* config, const wasi_output_buffer_t* buffer);
+
+/**
+ * \brief Configures standard error to be captured in `buffer`.
+ *
+ * This function doesn't take ownership of `buffer`.
+ */
+WASI_API_EXTERN void wasi_config_set_stderr_buffer(wasi_config_t* config, const wasi_output_buffer_t* buffer);
+
+/**
+ * \brief Callback receiving data written to a WASI output stream.
+ *
+ * Should return the number of bytes of `buf` consumed, which may be less than
+ * `len`, or a negative value to report an I/O error to the program.
+ */
+typedef ptrdiff_t (*wasi_output_callback_t)(void* env, const uint8_t* buf, size_t len);
+
+/**
+ * \brief Configures standard output to be passed to `callback` as it's
+ * written.
+ *
+ * `data` is passed as the `env` argument of `callback`, and `finalizer`, if
+ * not `NULL`, is called on `data` once the stream is no longer used.
+ */
+WASI_API_EXTERN void wasi_config_set_stdout_callback(wasi_config_t* config, wasi_output_callback_t callback, void* data, void (*finalizer)(void*));
+
+/**
+ * \brief Configures standard error to be passed to `callback` as it's
+ * written.
+ *
+ * See #wasi_config_set_stdout_callback.
+ */
+WASI_API_EXTERN void wasi_config_set_stderr_callback(wasi_config_t* config, wasi_output_callback_t callback, void* data, void (*finalizer)(void*));
+
 /**
  * \brief Configures a "preopened directory" to be available to WASI APIs.
  *
@@ -146,6 +229,44 @@ WASI_API_EXTERN void wasi_config_inherit_stderr(wasi_config_t* config);
  */
 WASI_API_EXTERN bool wasi_config_preopen_dir(wasi_config_t* config, const char* path, const char* guest_path);
 
+/**
+ * \typedef wasi_template_t
+ * \brief Convenience alias for #wasi_template_t
+ *
+ * \struct wasi_template_t
+ * \brief An immutable, prebuilt WASI configuration shared between stores.
+ *
+ * A template holds the arguments, environment variables and preopened
+ * directories of a #wasi_config_t, validated and opened once. Each store is
+ * then configured from it with #wasmtime_context_set_wasi_template, which
+ * duplicates the already-open directory handles instead of opening the
+ * directories again.
+ *
+ * Templates are reference counted and may be used from multiple threads at
+ * once. #wasi_template_clone is cheap.
+ *
+ * \fn void wasi_template_delete(wasi_template_t *);
+ * \brief Deletes a template.
+ */
+WASI_DECLARE_OWN(template)
+
+/**
+ * \brief Creates a new template from `config`.
+ *
+ * This function takes ownership of `config`. Only its arguments, environment
+ * and preopened directories are used; standard I/O is configured per store.
+ * If the arguments or environment are inherited they're read from the host
+ * process once, here.
+ *
+ * Returns `NULL` if an argument or environment variable isn't valid UTF-8.
+ */
+WASI_API_EXTERN own wasi_template_t* wasi_template_new(own wasi_config_t* config);
+
+/**
+ * \brief Returns a new reference to the same template.
+ */
+WASI_API_EXTERN own wasi_template_t* wasi_template_clone(const wasi_template_t* template_);
+
 #undef own
 
 #ifdef __cplusplus
@@ -181,6 +181,7 @@
 #define WASMTIME_API_H
 
 #include <wasi.h>
+#include <wasmtime/async.h>
 #include <wasmtime/config.h>
 #include <wasmtime/engine.h>
 #include <wasmtime/error.h>
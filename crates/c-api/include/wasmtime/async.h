@@ -0,0 +1,295 @@
+/**
+ * \file wasmtime/async.h
+ *
+ * \brief Wasmtime async functionality
+ *
+ * Async support in wasmtime allows WebAssembly to run on a separate native
+ * stack (a fiber) so that it can be suspended and resumed by the embedder.
+ * Calls are started with functions like #wasmtime_func_call_async, which
+ * return a #wasmtime_call_future_t that's driven to completion by repeatedly
+ * calling #wasmtime_call_future_poll. WebAssembly gives control back to the
+ * poller when it runs out of fuel (#wasmtime_context_out_of_fuel_async_yield),
+ * reaches an epoch deadline
+ * (#wasmtime_context_epoch_deadline_async_yield_and_update), or calls a host
+ * function defined with #wasmtime_linker_define_async_func that isn't ready
+ * yet.
+ *
+ * This allows a single thread to interleave the execution of many stores by
+ * polling each of their futures in turn, instead of using an OS thread per
+ * guest.
+ *
+ * Async support must be enabled with #wasmtime_config_async_support_set, and
+ * once it is the synchronous call and instantiation functions can no longer be
+ * used with stores of that engine.
+ *
+ * All the functions in this header are only available when the C API is built
+ * with the `async` feature, which is enabled by default.
+ */
+
+#ifndef WASMTIME_ASYNC_H
+#define WASMTIME_ASYNC_H
+
+#include <wasm.h>
+#include <wasmtime/config.h>
+#include <wasmtime/error.h>
+#include <wasmtime/func.h>
+#include <wasmtime/instance.h>
+#include <wasmtime/linker.h>
+#include <wasmtime/store.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Whether or not to enable support for asynchronous functions in
+ * Wasmtime.
+ *
+ * When enabled, the config can optionally define host functions with async.
+ * Instances created and functions called with this Config must be called
+ * through their asynchronous APIs, however. For example using
+ * #wasmtime_func_call will panic when used with this config.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.async_support
+ */
+WASMTIME_CONFIG_PROP(void, async_support, bool)
+
+/**
+ * \brief Configures the size of the stacks used for asynchronous execution.
+ *
+ * This setting configures the size of the stacks that are allocated for
+ * asynchronous execution.
+ *
+ * The value cannot be less than max_wasm_stack.
+ *
+ * The amount of stack space guaranteed for host functions is async_stack_size
+ * - max_wasm_stack, so take care not to set these two values close to one
+ * another; doing so may cause host functions to overflow the stack and abort
+ * the process.
+ *
+ * By default this option is 2 MiB.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.async_stack_size
+ */
+WASMTIME_CONFIG_PROP(void, async_stack_size, size_t)
+
+/**
+ * \brief Configures epoch-deadline expiration to yield to the async caller and
+ * then update the deadline.
+ *
+ * When epoch-interruption-instrumented code is executed on this store and the
+ * epoch deadline is reached before completion, with the store configured in
+ * this way, execution will yield (the future will return `false` from
+ * #wasmtime_call_future_poll) and the next poll will resume it with a new
+ * deadline `delta` ticks in the future.
+ *
+ * See also #wasmtime_config_epoch_interruption_set and
+ * #wasmtime_context_set_epoch_deadline.
+ */
+WASM_API_EXTERN void wasmtime_context_epoch_deadline_async_yield_and_update(
+    wasmtime_context_t *context,
+    uint64_t delta);
+
+/**
+ * \brief Configures a store to yield execution of async WebAssembly code
+ * periodically when fuel runs out.
+ *
+ * When fuel runs out, `fuel_to_inject` units of fuel are added to the store
+ * and execution yields back to the poller. This happens up to
+ * `injection_count` times, after which running out of fuel traps.
+ *
+ * See also #wasmtime_config_consume_fuel_set and #wasmtime_context_add_fuel.
+ */
+WASM_API_EXTERN void wasmtime_context_out_of_fuel_async_yield(
+    wasmtime_context_t *context,
+    uint64_t injection_count,
+    uint64_t fuel_to_inject);
+
+/**
+ * \brief The callback to determine a continuation's current state.
+ *
+ * Return true if the host call has completed, otherwise false will
+ * continue to yield WebAssembly execution.
+ */
+typedef bool (*wasmtime_func_async_continuation_callback_t)(void *env);
+
+/**
+ * \brief A continuation for the current state of the host function's
+ * execution.
+ */
+typedef struct wasmtime_async_continuation_t {
+  /// Callback for if the async function has completed.
+  wasmtime_func_async_continuation_callback_t callback;
+  /// User-provided argument to pass to the callback.
+  void *env;
+  /// A finalizer for the user-provided *env
+  void (*finalizer)(void *);
+} wasmtime_async_continuation_t;
+
+/**
+ * \brief Callback signature for #wasmtime_linker_define_async_func.
+ *
+ * This is a host function that returns a continuation to be called later.
+ *
+ * All the arguments to this function will be kept alive until the
+ * continuation returns that it has completed, so results may be written to
+ * `results` from within the continuation.
+ *
+ * If the host function fails immediately it should store a trap in `trap_ret`
+ * and leave `continuation_ret` alone. Otherwise it may fill in
+ * `continuation_ret`, which is polled each time the call's future is polled
+ * until it returns true. If `continuation_ret` is left as-is the host function
+ * completes as soon as the callback returns. A trap stored in `trap_ret` is
+ * returned from the WebAssembly call that reached this function, and in that
+ * case the continuation's finalizer still runs but its callback never does.
+ */
+typedef void (*wasmtime_func_async_callback_t)(
+    void *env,
+    wasmtime_caller_t *caller,
+    const wasmtime_val_t *args,
+    size_t nargs,
+    wasmtime_val_t *results,
+    size_t nresults,
+    wasm_trap_t **trap_ret,
+    wasmtime_async_continuation_t *continuation_ret);
+
+/**
+ * \brief An opaque type that represents a Wasmtime future.
+ *
+ * The future is created by functions like #wasmtime_func_call_async and
+ * driven with #wasmtime_call_future_poll.
+ *
+ * The future holds on to the store and all the output pointers given to the
+ * function that created it, so they must stay valid until the future is
+ * deleted.
+ */
+typedef struct wasmtime_call_future wasmtime_call_future_t;
+
+/**
+ * \brief Executes WebAssembly in the function.
+ *
+ * Returns true if the function call has completed, after which the outputs of
+ * the call (results, trap or error) are written and the future must not be
+ * polled again. Returns false if execution yielded and the future must be
+ * polled again to make progress.
+ */
+WASM_API_EXTERN bool wasmtime_call_future_poll(wasmtime_call_future_t *future);
+
+/**
+ * \brief Frees the underlying memory for a future.
+ *
+ * All #wasmtime_call_future_t are owned by the caller and should be deleted
+ * using this function. A future may be deleted before it completes, in which
+ * case the call is cancelled.
+ */
+WASM_API_EXTERN void wasmtime_call_future_delete(wasmtime_call_future_t *future);
+
+/**
+ * \brief Invokes this function with the params given, returning the results
+ * asynchronously.
+ *
+ * This function is the same as #wasmtime_func_call except that it is
+ * asynchronous. This is only compatible with stores associated with an
+ * asynchronous config.
+ *
+ * The result is a future that is owned by the caller and must be deleted via
+ * #wasmtime_call_future_delete.
+ *
+ * The `args` array is read before this function returns and doesn't need to
+ * outlive it. The `results`, `trap_ret` and `error_ret` pointers are written
+ * when the future completes and must be valid until then, as must `store` and
+ * `func`.
+ *
+ * When the future completes at most one of `trap_ret` and `error_ret` is
+ * written to, and `results` is only initialized if neither is:
+ *
+ * * `trap_ret` is set if the WebAssembly trapped, an async host function
+ *   stored a trap in its `trap_ret`, fuel ran out after the last injection
+ *   configured with #wasmtime_context_out_of_fuel_async_yield, or an epoch
+ *   deadline was reached without yielding configured.
+ * * `error_ret` is set if `nargs`, `nresults` or the types of `args` don't
+ *   match the function's type, or an argument belongs to another store.
+ *
+ * The call's temporary storage is returned to the store on all of these
+ * paths. It is not if the future is deleted before it completes, which only
+ * means the next call on the store allocates it again.
+ *
+ * Calling this with a store whose engine doesn't have async support enabled,
+ * or polling the returned future again after it completed, aborts the
+ * process.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *wasmtime_func_call_async(
+    wasmtime_context_t *context,
+    const wasmtime_func_t *func,
+    const wasmtime_val_t *args,
+    size_t nargs,
+    wasmtime_val_t *results,
+    size_t nresults,
+    wasm_trap_t **trap_ret,
+    wasmtime_error_t **error_ret);
+
+/**
+ * \brief Defines a new async function in this linker.
+ *
+ * This function behaves similar to #wasmtime_linker_define_func, except it
+ * supports async callbacks.
+ *
+ * The callback `cb` will be invoked on another stack (fiber for async
+ * execution).
+ *
+ * Returns an error if `module` or `name` aren't valid UTF-8 or the linker
+ * already defines the name and doesn't allow shadowing. Defining an async
+ * function in a linker whose engine doesn't have async support enabled aborts
+ * the process.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_linker_define_async_func(
+    wasmtime_linker_t *linker,
+    const char *module,
+    size_t module_len,
+    const char *name,
+    size_t name_len,
+    const wasm_functype_t *ty,
+    wasmtime_func_async_callback_t cb,
+    void *data,
+    void (*finalizer)(void *));
+
+/**
+ * \brief Instantiates a #wasm_module_t with the items defined in this linker
+ * for an async store.
+ *
+ * This is the same as #wasmtime_linker_instantiate but used for async stores
+ * (which requires functions are called asynchronously). The returning future
+ * must be polled using #wasmtime_call_future_poll.
+ *
+ * The caller owns the returned future and must delete it with
+ * #wasmtime_call_future_delete. `instance`, `trap_ret` and `error_ret` are
+ * written when the future completes and must be valid until then.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *wasmtime_linker_instantiate_async(
+    const wasmtime_linker_t *linker,
+    wasmtime_context_t *store,
+    const wasmtime_module_t *module,
+    wasmtime_instance_t *instance,
+    wasm_trap_t **trap_ret,
+    wasmtime_error_t **error_ret);
+
+/**
+ * \brief Instantiates a pre-linked module in an async store.
+ *
+ * This is the same as #wasmtime_instance_pre_instantiate but for async
+ * stores, with the same ownership rules as #wasmtime_linker_instantiate_async.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *wasmtime_instance_pre_instantiate_async(
+    const wasmtime_instance_pre_t *instance_pre,
+    wasmtime_context_t *store,
+    wasmtime_instance_t *instance,
+    wasm_trap_t **trap_ret,
+    wasmtime_error_t **error_ret);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif // WASMTIME_ASYNC_H
@@ -96,6 +96,31 @@ enum wasmtime_profiling_strategy_enum { // ProfilingStrategy
  */
 WASMTIME_CONFIG_PROP(void, debug_info, bool)
 
+/**
+ * \brief Configures whether traps capture a backtrace of WebAssembly frames.
+ *
+ * This setting is `true` by default. When disabled no stack walking happens
+ * when a trap is raised, and #wasm_trap_trace and #wasm_trap_origin return no
+ * frames. This makes trapping cheaper for programs that trap as part of
+ * normal control flow and only inspect #wasmtime_trap_code or
+ * #wasmtime_trap_exit_status.
+ */
+WASMTIME_CONFIG_PROP(void, wasm_backtrace, bool)
+
+/**
+ * \brief Configures whether trap backtraces are symbolized lazily.
+ *
+ * This setting is `false` by default. When enabled a trap only records the
+ * program counters of its frames, and function names, offsets and debug
+ * information are looked up the first time the trap's frames are requested
+ * with #wasm_trap_trace, #wasm_trap_origin or #wasm_trap_message. Traps which
+ * are never inspected beyond their code or exit status skip this work.
+ *
+ * This has no effect if #wasmtime_config_wasm_backtrace_set disables
+ * backtraces.
+ */
+WASMTIME_CONFIG_PROP(void, wasm_backtrace_lazy, bool)
+
 /**
  * \brief Whether or not fuel is enabled for generated code.
  *
@@ -261,6 +286,198 @@ WASMTIME_CONFIG_PROP(void, static_memory_guard_size, uint64_t)
  */
 WASMTIME_CONFIG_PROP(void, dynamic_memory_guard_size, uint64_t)
 
+/**
+ * \brief Configures whether linear memories are initialized by mapping a
+ * copy-on-write image of the module's data segments.
+ *
+ * When enabled, compiling a module lays out its data segments as a
+ * page-aligned image of initial memory, which is also kept in the output of
+ * #wasmtime_module_serialize. Instantiation then maps this image into each
+ * new linear memory instead of copying every data segment, so its cost no
+ * longer depends on how much data the module has. Modules loaded with
+ * #wasmtime_module_deserialize_file map the image directly from the file;
+ * other modules copy it once into an in-memory file on Linux.
+ *
+ * Modules whose data segments can't be laid out statically, for example
+ * because their offsets depend on imported globals, still have their data
+ * segments copied in. Use #wasmtime_module_uses_memory_image to check.
+ *
+ * This setting is `true` by default and is only available when the C API is
+ * built with the `memory-init-cow` feature.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.memory_init_cow.
+ */
+WASMTIME_CONFIG_PROP(void, memory_init_cow, bool)
+
+/**
+ * \brief Forces copy-on-write memory images to be held in an in-memory file
+ * on Linux instead of being mapped from a module's file on disk.
+ *
+ * This keeps page faults of newly instantiated memories from reading the
+ * disk, at the cost of a copy of the image in RAM per module.
+ *
+ * This setting is `false` by default and is only available when the C API is
+ * built with the `memory-init-cow` feature.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.force_memory_init_memfd.
+ */
+WASMTIME_CONFIG_PROP(void, force_memory_init_memfd, bool)
+
+/**
+ * \brief Configures the size below which a module's memory image is always
+ * created, even if its data segments are sparse.
+ *
+ * Sparse data segments would otherwise make the image mostly zeros, so by
+ * default no image is created when less than half of its pages contain data.
+ * Raising this guarantees copy-on-write initialization for modules whose
+ * initialized memory is smaller than `size` bytes.
+ *
+ * This setting is 16 MiB by default and is only available when the C API is
+ * built with the `memory-init-cow` feature.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.memory_guaranteed_dense_image_size.
+ */
+WASMTIME_CONFIG_PROP(void, memory_guaranteed_dense_image_size, uint64_t)
+
+/**
+ * \brief Switches instance allocation to the pooling allocator.
+ *
+ * By default resources for an instance are allocated when it's instantiated
+ * and released when its store is dropped. With the pooling allocator memories,
+ * tables and instance state are instead reserved up front for a fixed number
+ * of instances and reused across instantiations, which avoids an `mmap` and
+ * `munmap` pair per instance.
+ *
+ * The pool is sized by the `wasmtime_config_pooling_*_set` functions below,
+ * any of which also selects the pooling allocator. Limits not configured keep
+ * their defaults.
+ *
+ * For more information see the Rust documentation at
+ * https://bytecodealliance.github.io/wasmtime/api/wasmtime/enum.InstanceAllocationStrategy.html#variant.Pooling.
+ */
+WASM_API_EXTERN void wasmtime_config_allocation_strategy_pooling(wasm_config_t*);
+
+/**
+ * \brief Configures the maximum number of concurrent instances in the pool.
+ *
+ * This setting is 1000 by default.
+ */
+WASMTIME_CONFIG_PROP(void, pooling_instance_count, uint32_t)
+
+/**
+ * \brief Configures the maximum size, in bytes, of an instance's runtime
+ * state and `VMContext` in the pool.
+ *
+ * This setting is 1MB by default.
+ */
+WASMTIME_CONFIG_PROP(void, pooling_instance_size, size_t)
+
+/**
+ * \brief Configures the maximum number of defined tables per module in the
+ * pool.
+ *
+ * This setting is 1 by default.
+ */
+WASMTIME_CONFIG_PROP(void, pooling_max_tables, uint32_t)
+
+/**
+ * \brief Configures the maximum number of elements of any pooled table.
+ *
+ * This setting is 10000 by default.
+ */
+WASMTIME_CONFIG_PROP(void, pooling_table_elements, uint32_t)
+
+/**
+ * \brief Configures the maximum number of defined linear memories per module
+ * in the pool.
+ *
+ * This setting is 1 by default.
+ */
+WASMTIME_CONFIG_PROP(void, pooling_max_memories, uint32_t)
+
+/**
+ * \brief Configures the maximum number of 64KiB pages of any pooled linear
+ * memory.
+ *
+ * This setting is 160 by default. It can't exceed what
+ * #wasmtime_config_static_memory_maximum_size_set allows.
+ */
+WASMTIME_CONFIG_PROP(void, pooling_memory_pages, uint64_t)
+
+/**
+ * \brief Configures whether functions are compiled in parallel.
+ *
+ * This setting is `true` by default.
+ */
+WASMTIME_CONFIG_PROP(void, parallel_compilation, bool)
+
+/**
+ * \brief Configures the number of threads used to compile modules.
+ *
+ * When set to a nonzero value, engines created from this config get their own
+ * pool of this many compilation threads, used by #wasmtime_module_new,
+ * #wasmtime_module_validate, #wasm_module_new and #wasm_module_validate.
+ * Otherwise modules are compiled on a process-wide pool with one thread per
+ * CPU. If the threads can't be started, modules are compiled on the thread
+ * that creates them instead.
+ *
+ * This setting is 0 by default.
+ */
+WASMTIME_CONFIG_PROP(void, compilation_threads, size_t)
+
+/**
+ * \brief A compilation worker handed to a #wasmtime_compile_spawn_callback_t.
+ *
+ * Calling this with the `task` argument of the spawn callback runs the worker
+ * until the engine that owns it is deleted.
+ */
+typedef void (*wasmtime_compile_task_t)(void *task);
+
+/**
+ * \brief Callback used to start compilation worker threads.
+ *
+ * \param env the `data` passed to #wasmtime_config_compilation_spawn_set
+ * \param run the function the new thread should call
+ * \param task the argument to pass to `run`
+ *
+ * The callback should arrange for `run(task)` to be called on a thread of the
+ * embedder's choosing and return `true`, or return `false` if it can't. Each
+ * call to `run` occupies its thread until the engine is deleted, so workers
+ * should be dedicated threads rather than short-lived tasks of a pool that's
+ * also used for other work.
+ */
+typedef bool (*wasmtime_compile_spawn_callback_t)(void *env, wasmtime_compile_task_t run, void *task);
+
+/**
+ * \brief Configures how compilation threads are started.
+ *
+ * \param config the config to modify
+ * \param callback the callback used to start each compilation thread, or
+ *        `NULL` to let Wasmtime create its own threads
+ * \param data the `env` argument passed to `callback`
+ * \param finalizer an optional finalizer for `data`
+ *
+ * When set, engines created from this config use a dedicated compilation pool
+ * whose threads are started through `callback`. The number of threads is
+ * configured with #wasmtime_config_compilation_threads_set, defaulting to one
+ * per CPU. If any thread fails to start, the engine doesn't compile in
+ * parallel at all: modules are compiled on the thread that creates them.
+ *
+ * `callback` is only invoked while #wasm_engine_new_with_config is creating
+ * the engine, and the finalizer for `data` runs once the config has been
+ * consumed or deleted. If `callback` is `NULL` then `finalizer` is run
+ * immediately.
+ */
+WASM_API_EXTERN void wasmtime_config_compilation_spawn_set(
+    wasm_config_t *config,
+    wasmtime_compile_spawn_callback_t callback,
+    void *data,
+    void (*finalizer)(void*)
+);
+
 /**
  * \brief Enables Wasmtime's cache and loads configuration from the specified
  * path.
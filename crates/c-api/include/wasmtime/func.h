@@ -214,6 +214,75 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_func_call(
     wasm_trap_t **trap
 );
 
+/**
+ * \brief Call a WebAssembly function, reporting WASI exits without a trap.
+ *
+ * This is the same as #wasmtime_func_call except for how an explicit exit
+ * of the program, such as WASI's `proc_exit`, is reported. Instead of
+ * allocating a #wasm_trap_t to be inspected with #wasmtime_trap_exit_status,
+ * `true` is written to `exited`, the status is written to `exit_status`, and
+ * the returned error, `trap` and `results` are left untouched. No backtrace
+ * is captured for such an exit.
+ *
+ * `exited` is always written to, and is `false` in every other state
+ * described by #wasmtime_func_call. None of `trap`, `exited` or `exit_status`
+ * may be `NULL`.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_func_call_with_exit(
+    wasmtime_context_t *store,
+    const wasmtime_func_t *func,
+    const wasmtime_val_t *args,
+    size_t nargs,
+    wasmtime_val_t *results,
+    size_t nresults,
+    wasm_trap_t **trap,
+    bool *exited,
+    int *exit_status
+);
+
+/**
+ * \brief Calls a WebAssembly function once for each element of a batch.
+ *
+ * \param store the store that owns `func`
+ * \param func the function to call
+ * \param args `nargs * nbatch` arguments, `nargs` per call
+ * \param nargs the number of parameters `func` takes
+ * \param results space for `nresults * nbatch` results, `nresults` per call
+ * \param nresults the number of results `func` returns
+ * \param nbatch the number of calls to make
+ * \param trap_index where to store the number of calls that completed
+ * \param trap where to store a trap, if one happens
+ *
+ * This behaves like calling #wasmtime_func_call `nbatch` times, with the
+ * arguments of call `i` starting at `args[i * nargs]` and its results written
+ * starting at `results[i * nresults]`. The function's type is looked up once
+ * for the whole batch, and for functions whose parameters and results are all
+ * numeric or v128 every argument is type-checked before the first call so the
+ * calls themselves take the unchecked path.
+ *
+ * Calls stop at the first trap, which is returned through `trap`. In all cases
+ * `trap_index` is set to the number of calls that completed, and only the
+ * results of those calls are written. An error is returned without making any
+ * calls if `func` isn't owned by `store` or if `nargs` or `nresults` doesn't
+ * match `func`. A mistyped argument is
+ * also an error; for functions with reference-typed parameters or results it's
+ * only detected when its own call is reached.
+ *
+ * Does not take ownership of #wasmtime_val_t arguments. Gives ownership of
+ * #wasmtime_val_t results.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_func_call_batch(
+    wasmtime_context_t *store,
+    const wasmtime_func_t *func,
+    const wasmtime_val_t *args,
+    size_t nargs,
+    wasmtime_val_t *results,
+    size_t nresults,
+    size_t nbatch,
+    size_t *trap_index,
+    wasm_trap_t **trap
+);
+
 /**
  * \brief Call a WebAssembly function in an "unchecked" fashion.
  *
@@ -247,6 +316,83 @@ WASM_API_EXTERN wasm_trap_t *wasmtime_func_call_unchecked(
     wasmtime_val_raw_t *args_and_results
 );
 
+/**
+ * \typedef wasmtime_typed_func_t
+ * \brief Convenience alias for #wasmtime_typed_func
+ *
+ * \struct wasmtime_typed_func
+ * \brief A #wasmtime_func_t whose signature has been checked once up front.
+ *
+ * Created with #wasmtime_func_typed and called with
+ * #wasmtime_typed_func_call. Like #wasmtime_func_t this has no destructor and
+ * is only valid with the store that owns the function.
+ */
+typedef struct wasmtime_typed_func {
+  /// The function being called.
+  wasmtime_func_t func;
+  /// Number of parameters the function takes.
+  size_t nparams;
+  /// Number of results the function returns.
+  size_t nresults;
+} wasmtime_typed_func_t;
+
+/**
+ * \brief Checks the signature of a function against `signature` and returns a
+ * handle to call it without further type checks.
+ *
+ * \param store the store that owns `func`
+ * \param func the function to check
+ * \param signature the expected signature, see below
+ * \param signature_len the byte length of `signature`
+ * \param typed where to store the typed function on success
+ *
+ * The signature is one character per parameter, a `:`, then one character per
+ * result. The characters are `i` for i32, `I` for i64, `f` for f32, `F` for
+ * f64, `v` for v128, `r` for funcref and `e` for externref. For example a
+ * function of type `(i32, i32) -> i32` has the signature `"ii:i"` and one of
+ * type `() -> ()` has `":"`.
+ *
+ * Returns an error if `store` doesn't own `func` or the function's type doesn't
+ * match `signature`, in which case `typed` isn't written to.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_func_typed(
+    const wasmtime_context_t *store,
+    const wasmtime_func_t *func,
+    const char *signature,
+    size_t signature_len,
+    wasmtime_typed_func_t *typed
+);
+
+/**
+ * \brief Calls a function whose signature was checked by
+ * #wasmtime_func_typed.
+ *
+ * \param store the store that owns the function
+ * \param func the typed function to call
+ * \param args_and_results parameters on input and results on output
+ * \param args_and_results_len the number of values `args_and_results` holds
+ * \param trap where to store a trap, if one happens
+ *
+ * This works like #wasmtime_func_call_unchecked: parameters are read from
+ * index 0 of `args_and_results` and results are written over them, also from
+ * index 0. The values are not converted and their types aren't checked, the
+ * signature check in #wasmtime_func_typed takes the place of that. The only
+ * per-call checks are that `store` owns the function and that
+ * `args_and_results_len` can hold both the parameters and the results,
+ * returning an error otherwise.
+ *
+ * On success `NULL` is returned and `trap` is either left alone or filled in
+ * if the function trapped. Unlike #wasmtime_func_call Rust panics are not
+ * caught and turned into traps.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_typed_func_call(
+    wasmtime_context_t *store,
+    const wasmtime_typed_func_t *func,
+    wasmtime_val_raw_t *args_and_results,
+    size_t args_and_results_len,
+    wasm_trap_t **trap
+);
+
 /**
  * \brief Loads a #wasmtime_extern_t from the caller's context
  *
@@ -121,6 +121,88 @@ WASM_API_EXTERN bool wasmtime_instance_export_nth(
     wasmtime_extern_t *item
 );
 
+/**
+ * \brief Resets an instance to the state it was in right after instantiation.
+ *
+ * \param store the store that owns `instance`
+ * \param instance the instance to reset
+ * \param trap_ptr where to store the returned trap
+ *
+ * This allows a store and instance to be reused for another request instead
+ * of creating a new instance each time. Memories defined by the instance are
+ * shrunk back to their initial size and their contents restored, either by
+ * remapping the module's copy-on-write image or by discarding the pages and
+ * copying the data segments in again. Defined tables and globals are
+ * re-initialized and the module's start function, if any, is run again.
+ *
+ * Imported items and host-side state, such as WASI file descriptors, are not
+ * reset, and active data and element segments targeting imported memories and
+ * tables aren't applied again. Pointers previously obtained with
+ * #wasmtime_memory_data may no longer be valid afterwards and memory views
+ * become stale. The growth of the reset memories and tables is taken back out
+ * of #wasmtime_context_limiter_usage.
+ *
+ * This function returns an error if WebAssembly is currently executing in
+ * `store` or if the instance's memories can't be reset, for example because
+ * they're shared or come from the pooling allocator without a copy-on-write
+ * image. If re-initialization or the start function traps then the trap is
+ * stored in `trap_ptr` and `NULL` is returned; the instance should not be
+ * used further in that case.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_instance_reset(
+    wasmtime_context_t *store,
+    const wasmtime_instance_t *instance,
+    wasm_trap_t **trap_ptr
+);
+
+/**
+ * \typedef wasmtime_instance_pre_t
+ * \brief Convenience alias for #wasmtime_instance_pre
+ *
+ * \struct wasmtime_instance_pre
+ * \brief A module whose imports have already been resolved and type-checked
+ * against a linker, ready to be instantiated cheaply.
+ *
+ * This type corresponds to the `wasmtime::InstancePre` type in Rust and is
+ * created with #wasmtime_linker_instantiate_pre. Each
+ * #wasmtime_instance_pre_instantiate then skips looking up imports by name and
+ * checking their types, which makes it a good fit for creating many
+ * short-lived instances of the same module.
+ */
+typedef struct wasmtime_instance_pre wasmtime_instance_pre_t;
+
+/**
+ * \brief Deletes a #wasmtime_instance_pre_t.
+ */
+WASM_API_EXTERN void wasmtime_instance_pre_delete(wasmtime_instance_pre_t *instance_pre);
+
+/**
+ * \brief Instantiates the pre-resolved module within `store`.
+ *
+ * \param instance_pre the pre-resolved module to instantiate
+ * \param store the store in which to create the instance
+ * \param instance where to store the returned instance
+ * \param trap where to store the returned trap
+ *
+ * The return values follow the same conventions as #wasmtime_instance_new.
+ *
+ * If the linker that created `instance_pre` only defined host functions then
+ * `store` can be any store of the same engine. Otherwise the imports belong to
+ * the store passed to #wasmtime_linker_instantiate_pre and `store` must be
+ * that same store, or this function will abort the process.
+ *
+ * This function does not take ownership of any of its arguments.
+ *
+ * For more information see the Rust documentation at
+ * https://bytecodealliance.github.io/wasmtime/api/wasmtime/struct.InstancePre.html#method.instantiate.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_instance_pre_instantiate(
+    const wasmtime_instance_pre_t *instance_pre,
+    wasmtime_context_t *store,
+    wasmtime_instance_t *instance,
+    wasm_trap_t **trap
+);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
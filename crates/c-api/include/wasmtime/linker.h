@@ -11,6 +11,7 @@
 #include <wasmtime/error.h>
 #include <wasmtime/store.h>
 #include <wasmtime/extern.h>
+#include <wasmtime/instance.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -216,6 +217,33 @@ WASM_API_EXTERN wasmtime_error_t* wasmtime_linker_instantiate(
     wasm_trap_t **trap
 );
 
+/**
+ * \brief Resolves and type-checks the imports of a module once, so that it
+ * can be instantiated repeatedly without going through the linker again.
+ *
+ * \param linker the linker used to resolve the imports of `module`
+ * \param store the store that items defined in the linker belong to
+ * \param module the module whose imports are resolved
+ * \param instance_pre where to store the returned #wasmtime_instance_pre_t
+ *
+ * \return An error if any import of `module` isn't defined in the linker or
+ * is defined with the wrong type, otherwise `NULL` is returned and
+ * `instance_pre` is filled in. The caller owns the returned value and must
+ * delete it with #wasmtime_instance_pre_delete.
+ *
+ * Note that the start function is not run here, it runs as part of each
+ * #wasmtime_instance_pre_instantiate.
+ *
+ * For more information see the [Rust
+ * documentation](https://bytecodealliance.github.io/wasmtime/api/wasmtime/struct.Linker.html#method.instantiate_pre).
+ */
+WASM_API_EXTERN wasmtime_error_t* wasmtime_linker_instantiate_pre(
+    const wasmtime_linker_t *linker,
+    wasmtime_context_t *store,
+    const wasmtime_module_t *module,
+    wasmtime_instance_pre_t **instance_pre
+);
+
 /**
  * \brief Defines automatic instantiations of a #wasm_module_t in this linker.
  *
@@ -290,6 +318,81 @@ WASM_API_EXTERN bool wasmtime_linker_get(
     wasmtime_extern_t *item
 );
 
+/**
+ * \typedef wasmtime_frozen_linker_t
+ * \brief Alias to #wasmtime_frozen_linker
+ *
+ * \struct #wasmtime_frozen_linker
+ * \brief An immutable snapshot of a #wasmtime_linker_t.
+ *
+ * A frozen linker is created with #wasmtime_linker_freeze and can't be
+ * modified afterwards. Unlike #wasmtime_linker_t it's safe to use a frozen
+ * linker from any number of threads at the same time without external
+ * locking, so one snapshot can serve instantiations across all threads of a
+ * host. Copies made with #wasmtime_frozen_linker_clone share the same
+ * underlying definitions.
+ *
+ * Name lookups go through the snapshot's definitions each time a module is
+ * instantiated. To resolve a module's imports just once, create a
+ * #wasmtime_instance_pre_t with #wasmtime_frozen_linker_instantiate_pre and
+ * instantiate that instead.
+ *
+ * Items defined from a particular store, for example with
+ * #wasmtime_linker_define_instance, can only be used with that store. Linkers
+ * meant to be shared between stores should contain only functions defined
+ * with #wasmtime_linker_define_func and friends or #wasmtime_linker_define_wasi.
+ */
+typedef struct wasmtime_frozen_linker wasmtime_frozen_linker_t;
+
+/**
+ * \brief Creates an immutable snapshot of the definitions in `linker`.
+ *
+ * Later changes to `linker` aren't reflected in the snapshot. The returned
+ * snapshot is owned by the caller and must be deleted with
+ * #wasmtime_frozen_linker_delete.
+ */
+WASM_API_EXTERN wasmtime_frozen_linker_t* wasmtime_linker_freeze(const wasmtime_linker_t *linker);
+
+/**
+ * \brief Returns another reference to the same frozen linker.
+ *
+ * This is cheap and doesn't copy any definitions. Both the original and the
+ * clone must be deleted with #wasmtime_frozen_linker_delete.
+ */
+WASM_API_EXTERN wasmtime_frozen_linker_t* wasmtime_frozen_linker_clone(const wasmtime_frozen_linker_t *linker);
+
+/**
+ * \brief Deletes a frozen linker.
+ */
+WASM_API_EXTERN void wasmtime_frozen_linker_delete(wasmtime_frozen_linker_t *linker);
+
+/**
+ * \brief Same as #wasmtime_linker_instantiate, but for a frozen linker.
+ *
+ * This may be called concurrently from multiple threads with the same
+ * `linker`, as long as each thread uses its own `store`.
+ */
+WASM_API_EXTERN wasmtime_error_t* wasmtime_frozen_linker_instantiate(
+    const wasmtime_frozen_linker_t *linker,
+    wasmtime_context_t *store,
+    const wasmtime_module_t *module,
+    wasmtime_instance_t *instance,
+    wasm_trap_t **trap
+);
+
+/**
+ * \brief Same as #wasmtime_linker_instantiate_pre, but for a frozen linker.
+ *
+ * This may be called concurrently from multiple threads with the same
+ * `linker`, as long as each thread uses its own `store`.
+ */
+WASM_API_EXTERN wasmtime_error_t* wasmtime_frozen_linker_instantiate_pre(
+    const wasmtime_frozen_linker_t *linker,
+    wasmtime_context_t *store,
+    const wasmtime_module_t *module,
+    wasmtime_instance_pre_t **instance_pre
+);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -116,6 +116,153 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_memory_grow(
     uint64_t *prev_size
 );
 
+/**
+ * \brief A cached view of a linear memory's contents.
+ *
+ * The `base` and `length` of a memory can only change when a memory in its
+ * store grows or is reset with #wasmtime_instance_reset. Every time that's
+ * about to happen the store's memory
+ * generation, see #wasmtime_context_memory_generation, is incremented, so a
+ * view whose `generation` is still current has a valid `base` and `length`.
+ *
+ * Hosts that want to avoid re-querying memory on every call can keep a view
+ * around and refresh it with #wasmtime_memory_view_refresh, or register a
+ * callback with #wasmtime_store_memory_growth_callback to learn exactly when
+ * the view needs refreshing.
+ */
+typedef struct wasmtime_memory_view {
+  /// Base pointer of the memory's contents.
+  uint8_t *base;
+  /// Byte length of the memory's contents.
+  size_t length;
+  /// Store memory generation this view was taken at.
+  uint64_t generation;
+} wasmtime_memory_view_t;
+
+/**
+ * \brief Fills in `view` with the current base, length and generation of
+ * `memory`.
+ */
+WASM_API_EXTERN void wasmtime_memory_view_get(
+    const wasmtime_context_t *store,
+    const wasmtime_memory_t *memory,
+    wasmtime_memory_view_t *view
+);
+
+/**
+ * \brief Refreshes `view` if a memory in `store` may have grown since it was
+ * taken.
+ *
+ * Returns `false` and leaves `view` alone if the store's memory generation
+ * still matches `view->generation`. Otherwise `view` is re-read from `memory`
+ * and `true` is returned.
+ */
+WASM_API_EXTERN bool wasmtime_memory_view_refresh(
+    const wasmtime_context_t *store,
+    const wasmtime_memory_t *memory,
+    wasmtime_memory_view_t *view
+);
+
+/**
+ * \brief Copies `len` bytes of `memory` starting at `offset` into `buf`.
+ *
+ * Returns an error, without copying anything, if the range `offset` to
+ * `offset + len` isn't entirely within the memory. `buf` must not point into
+ * `memory` itself, see #wasmtime_memory_copy_within for that.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_memory_read(
+    const wasmtime_context_t *store,
+    const wasmtime_memory_t *memory,
+    uint64_t offset,
+    uint8_t *buf,
+    size_t len
+);
+
+/**
+ * \brief Copies `len` bytes from `buf` into `memory` starting at `offset`.
+ *
+ * Returns an error, without copying anything, if the range `offset` to
+ * `offset + len` isn't entirely within the memory. `buf` must not point into
+ * `memory` itself, see #wasmtime_memory_copy_within for that.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_memory_write(
+    wasmtime_context_t *store,
+    const wasmtime_memory_t *memory,
+    uint64_t offset,
+    const uint8_t *buf,
+    size_t len
+);
+
+/**
+ * \brief Sets `len` bytes of `memory` starting at `offset` to `val`.
+ *
+ * Returns an error, without writing anything, if the range `offset` to
+ * `offset + len` isn't entirely within the memory.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_memory_fill(
+    wasmtime_context_t *store,
+    const wasmtime_memory_t *memory,
+    uint64_t offset,
+    uint8_t val,
+    size_t len
+);
+
+/**
+ * \brief Copies `len` bytes of `memory` from `src` to `dst`.
+ *
+ * The two ranges may overlap. Returns an error, without copying anything, if
+ * either range isn't entirely within the memory.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_memory_copy_within(
+    wasmtime_context_t *store,
+    const wasmtime_memory_t *memory,
+    uint64_t dst,
+    uint64_t src,
+    size_t len
+);
+
+/**
+ * \brief A host buffer paired with a range of linear memory, used by
+ * #wasmtime_memory_readv and #wasmtime_memory_writev.
+ */
+typedef struct wasmtime_memory_iovec {
+  /// Byte offset in linear memory.
+  uint64_t offset;
+  /// Host buffer to copy to or from.
+  uint8_t *buf;
+  /// Number of bytes to copy.
+  size_t len;
+} wasmtime_memory_iovec_t;
+
+/**
+ * \brief Reads several ranges of `memory` into host buffers in one call.
+ *
+ * For each of the `niovs` entries in `iovs` this behaves like
+ * #wasmtime_memory_read. All ranges are checked before anything is copied, so
+ * if any is out of bounds an error is returned and no buffer is written.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_memory_readv(
+    const wasmtime_context_t *store,
+    const wasmtime_memory_t *memory,
+    const wasmtime_memory_iovec_t *iovs,
+    size_t niovs
+);
+
+/**
+ * \brief Writes several host buffers into ranges of `memory` in one call.
+ *
+ * For each of the `niovs` entries in `iovs` this behaves like
+ * #wasmtime_memory_write. All ranges are checked before anything is copied,
+ * so if any is out of bounds an error is returned and memory is left
+ * unmodified.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_memory_writev(
+    wasmtime_context_t *store,
+    const wasmtime_memory_t *memory,
+    const wasmtime_memory_iovec_t *iovs,
+    size_t niovs
+);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -135,6 +135,11 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_module_deserialize(
  * reads the data for the serialized module from the path on disk. This can be
  * faster than the alternative which may require copying the data around.
  *
+ * The file is mapped privately and read-only, and its code is never written
+ * to, only made executable. Every process that loads the same file therefore
+ * shares one copy of the code through the page cache, which can be observed
+ * with #wasmtime_module_image_stats.
+ *
  * This function does not take ownership of any of its arguments, but the
  * returned error and module are owned by the caller.
  *
@@ -148,6 +153,73 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_module_deserialize_file(
     wasmtime_module_t **ret
 );
 
+/**
+ * \brief Creates a module's copy-on-write memory image now instead of on its
+ * first instantiation.
+ *
+ * When #wasmtime_config_memory_init_cow_set is enabled the image of a
+ * module's initial memory is set up lazily. For modules compiled or
+ * deserialized from bytes this copies the image into an in-memory file on
+ * Linux, which this function allows to happen ahead of the first request
+ * instead. Calling it is optional.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_module_initialize_memory_image(
+    const wasmtime_module_t *module
+);
+
+/**
+ * \brief Returns whether instantiating a module maps its memories from a
+ * copy-on-write image.
+ *
+ * On success `ret` is set to `true` if instantiation maps the module's
+ * memories from its precompiled image, making its cost independent of the
+ * size of the data segments, or `false` if the data segments are copied in
+ * at each instantiation or the module's memories have no data. This creates
+ * the image if it doesn't exist yet, see
+ * #wasmtime_module_initialize_memory_image.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_module_uses_memory_image(
+    const wasmtime_module_t *module,
+    bool *ret
+);
+
+/**
+ * \brief Memory usage of a module's compiled image, see
+ * #wasmtime_module_image_stats.
+ */
+typedef struct wasmtime_module_image_stats {
+  /// Bytes of address space taken by the image.
+  size_t mapped;
+  /// Bytes of the image resident in physical memory.
+  size_t resident;
+  /// Resident bytes also mapped by other processes.
+  size_t shared;
+  /// Resident bytes that were copied or written and belong only to this
+  /// process.
+  size_t private_dirty;
+  /// Whether the image is mapped directly from the file it was deserialized
+  /// from, see #wasmtime_module_deserialize_file.
+  bool file_backed;
+} wasmtime_module_image_stats_t;
+
+/**
+ * \brief Reports how much of a module's compiled image is resident and how
+ * much of that is shared with other processes.
+ *
+ * A module loaded with #wasmtime_module_deserialize_file is `file_backed`,
+ * and its code pages count as `shared` once another process maps the same
+ * file. Modules compiled or deserialized from bytes are in anonymous memory,
+ * so all their resident pages are `private_dirty`.
+ *
+ * Page counts are read from `/proc/self/smaps`, so an error is returned on
+ * platforms other than Linux. Counts cover whole pages of the mappings that
+ * hold the image.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_module_image_stats(
+    const wasmtime_module_t *module,
+    wasmtime_module_image_stats_t *stats
+);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
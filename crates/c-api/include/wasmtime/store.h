@@ -84,6 +84,208 @@ WASM_API_EXTERN wasmtime_context_t *wasmtime_store_context(wasmtime_store_t *sto
  */
 WASM_API_EXTERN void wasmtime_store_delete(wasmtime_store_t *store);
 
+/**
+ * \brief Callback invoked when a memory in a store is about to grow.
+ *
+ * \param env the `data` passed to #wasmtime_store_memory_growth_callback
+ * \param current the current byte size of the memory
+ * \param desired the byte size the memory is growing to
+ *
+ * This is also invoked when a memory is first created, with a `current` size
+ * of zero. The memory hasn't been resized yet when this is called, so the
+ * callback shouldn't re-read the memory's data pointer; it should instead
+ * note that any cached #wasmtime_memory_view_t is stale.
+ */
+typedef void (*wasmtime_memory_growth_callback_t)(void *env, size_t current, size_t desired);
+
+/**
+ * \brief Registers a callback to be invoked whenever a memory in this store
+ * is about to grow.
+ *
+ * \param store the store to register the callback with
+ * \param callback the callback to invoke, or `NULL` to remove the callback
+ * \param data the `env` argument passed to `callback`
+ * \param finalizer an optional finalizer for `data`
+ *
+ * This replaces any previously registered callback, running the finalizer of
+ * its data. If `callback` is `NULL` then `finalizer` is run immediately.
+ */
+WASM_API_EXTERN void wasmtime_store_memory_growth_callback(
+    wasmtime_store_t *store,
+    wasmtime_memory_growth_callback_t callback,
+    void *data,
+    void (*finalizer)(void*)
+);
+
+/**
+ * \brief Provides limits for a store, used by hosts to restrict access to
+ * resources.
+ *
+ * \param store the store to configure
+ * \param memory_size the maximum number of bytes a linear memory can grow to
+ * \param table_elements the maximum number of elements in a table
+ * \param instances the maximum number of instances that can be created
+ * \param tables the maximum number of tables that can be created
+ * \param memories the maximum number of linear memories that can be created
+ *
+ * A negative value for any of the arguments leaves that resource at its
+ * default: memories and tables may grow without a limit, and 10000 instances,
+ * tables and memories may be created. Growing a memory or table beyond its
+ * limit fails the grow, and creating one beyond its limit fails
+ * instantiation.
+ *
+ * Calling this again replaces the limits previously configured.
+ */
+WASM_API_EXTERN void wasmtime_store_limiter(
+    wasmtime_store_t *store,
+    int64_t memory_size,
+    int64_t table_elements,
+    int64_t instances,
+    int64_t tables,
+    int64_t memories
+);
+
+/**
+ * \brief Callback deciding whether a memory in a store may grow.
+ *
+ * \param env the `data` passed to #wasmtime_store_limiter_callbacks
+ * \param current the current byte size of the memory, zero when the memory
+ *        is being created
+ * \param desired the byte size the memory wants to grow to
+ *
+ * Returns whether the growth is allowed.
+ */
+typedef bool (*wasmtime_memory_growing_callback_t)(void *env, size_t current, size_t desired);
+
+/**
+ * \brief Callback deciding whether a table in a store may grow.
+ *
+ * \param env the `data` passed to #wasmtime_store_limiter_callbacks
+ * \param current the current number of elements in the table, zero when the
+ *        table is being created
+ * \param desired the number of elements the table wants to grow to
+ *
+ * Returns whether the growth is allowed.
+ */
+typedef bool (*wasmtime_table_growing_callback_t)(void *env, uint32_t current, uint32_t desired);
+
+/**
+ * \brief Registers callbacks deciding whether memories and tables in this
+ * store may grow.
+ *
+ * \param store the store to register the callbacks with
+ * \param memory_growing invoked before a memory is created or grown, may be
+ *        `NULL`
+ * \param table_growing invoked before a table is created or grown, may be
+ *        `NULL`
+ * \param data the `env` argument passed to the callbacks
+ * \param finalizer an optional finalizer for `data`
+ *
+ * The callbacks are only consulted for growth within the limits configured
+ * with #wasmtime_store_limiter. They are invoked while WebAssembly is
+ * executing and must not call back into the store.
+ *
+ * This replaces any previously registered callbacks, running the finalizer of
+ * their data. If both callbacks are `NULL` then `finalizer` is run
+ * immediately.
+ */
+WASM_API_EXTERN void wasmtime_store_limiter_callbacks(
+    wasmtime_store_t *store,
+    wasmtime_memory_growing_callback_t memory_growing,
+    wasmtime_table_growing_callback_t table_growing,
+    void *data,
+    void (*finalizer)(void*)
+);
+
+/**
+ * \brief Resources the limiter of a store has granted it, see
+ * #wasmtime_context_limiter_usage.
+ */
+typedef struct wasmtime_store_limiter_usage {
+  /// Cumulative number of linear memory bytes granted to the store.
+  size_t memory_bytes;
+  /// Cumulative number of table elements granted to the store.
+  uint64_t table_elements;
+} wasmtime_store_limiter_usage_t;
+
+/**
+ * \brief Returns the resources the limiter of this store has granted it so
+ * far.
+ *
+ * These counters are the cumulative bytes and elements the limiter granted
+ * as memories and tables were created and grown. Growth that was refused, or
+ * that failed after being granted, isn't counted. They're kept up to date as
+ * that happens, so reading them is cheap. They count the sizes WebAssembly
+ * sees, which are committed as they're touched; address space reserved up
+ * front for a memory, such as its guard region, isn't included.
+ */
+WASM_API_EXTERN void wasmtime_context_limiter_usage(
+    const wasmtime_context_t *context,
+    wasmtime_store_limiter_usage_t *usage
+);
+
+/**
+ * \brief Statistics for a single linear memory, see
+ * #wasmtime_context_memory_stats.
+ */
+typedef struct wasmtime_linear_memory_stats {
+  /// The current byte size of the memory.
+  size_t byte_size;
+  /// How many of those bytes are resident in physical memory.
+  size_t resident_bytes;
+} wasmtime_linear_memory_stats_t;
+
+/**
+ * \brief An estimate of the memory used by a store, see
+ * #wasmtime_context_memory_stats.
+ */
+typedef struct wasmtime_memory_stats {
+  /// The number of linear memories defined in the store.
+  size_t memories;
+  /// The total byte size of the store's linear memories.
+  size_t memory_bytes;
+  /// How many bytes of the store's linear memories are resident.
+  size_t memory_resident_bytes;
+  /// Bytes of host memory used for the elements of the store's tables.
+  size_t table_bytes;
+  /// Bytes of host memory used for the runtime state of the store's
+  /// instances.
+  size_t instance_bytes;
+  /// Size of the compiled code of modules instantiated in the store. This
+  /// code is shared with other stores using the same modules, so it shouldn't
+  /// be summed across stores.
+  size_t code_bytes;
+} wasmtime_memory_stats_t;
+
+/**
+ * \brief Returns an estimate of the memory used by a store.
+ *
+ * \param context the store to inspect
+ * \param resident whether to ask the operating system how much of each
+ *        linear memory is resident
+ * \param stats where to write the totals for the store
+ * \param memories where to write statistics for each linear memory, in the
+ *        order they were created; may be `NULL` if `nmemories` is zero
+ * \param nmemories the length of `memories`
+ *
+ * At most `nmemories` entries of `memories` are written; `stats->memories`
+ * reports how many linear memories there are in total.
+ *
+ * When `resident` is `false` this only reads sizes the store already tracks,
+ * which makes it cheap enough to call frequently for many stores. When it's
+ * `true` residency is queried with `mincore` on Unix, at a cost proportional
+ * to the size of the memories. If residency isn't requested or can't be
+ * determined, each memory's `resident_bytes` is its `byte_size`, an upper
+ * bound.
+ */
+WASM_API_EXTERN void wasmtime_context_memory_stats(
+    wasmtime_context_t *context,
+    bool resident,
+    wasmtime_memory_stats_t *stats,
+    wasmtime_linear_memory_stats_t *memories,
+    size_t nmemories
+);
+
 /**
  * \brief Returns the user-specified data associated with the specified store
  */
@@ -98,17 +300,120 @@ WASM_API_EXTERN void *wasmtime_context_get_data(const wasmtime_context_t* contex
  */
 WASM_API_EXTERN void wasmtime_context_set_data(wasmtime_context_t* context, void *data);
 
+/**
+ * \brief Returns the memory generation of this store.
+ *
+ * The generation is incremented every time a memory within the store is
+ * created, about to grow, or reset with #wasmtime_instance_reset, and is used
+ * to tell whether a #wasmtime_memory_view_t is stale.
+ */
+WASM_API_EXTERN uint64_t wasmtime_context_memory_generation(const wasmtime_context_t* context);
+
 /**
  * \brief Perform garbage collection within the given context.
  *
  * Garbage collects `externref`s that are used within this store. Any
  * `externref`s that are discovered to be unreachable by other code or objects
- * will have their finalizers run.
+ * will have their finalizers run, subject to
+ * #wasmtime_context_set_gc_release_budget.
  *
  * The `context` argument must not be NULL.
  */
 WASM_API_EXTERN void wasmtime_context_gc(wasmtime_context_t* context);
 
+/**
+ * \brief Statistics about the garbage collection of `externref`s in a store,
+ * see #wasmtime_context_gc_step and #wasmtime_context_gc_stats.
+ */
+typedef struct wasmtime_gc_stats {
+  /// The number of collections performed.
+  uint64_t collections;
+  /// The number of `externref` roots found in WebAssembly frames on the stack.
+  uint64_t roots_scanned;
+  /// The number of references no longer used by WebAssembly that were
+  /// dropped.
+  uint64_t refs_released;
+  /// How many of the released references were the last reference to their
+  /// data, whose finalizer was then run.
+  uint64_t refs_freed;
+  /// The number of unused references still waiting to be dropped by a later
+  /// collection.
+  uint64_t refs_pending;
+  /// The time spent collecting, in nanoseconds.
+  uint64_t pause_nanos;
+} wasmtime_gc_stats_t;
+
+/**
+ * \brief Performs one bounded step of garbage collection within the given
+ * context.
+ *
+ * \param context the context to collect in
+ * \param max_refs the maximum number of unused references to drop
+ * \param max_time_nanos the time after which to stop dropping references, or
+ *        0 for no time limit
+ * \param stats where to write the statistics for this step, or `NULL`
+ *
+ * Like #wasmtime_context_gc this finds the `externref`s still used by
+ * WebAssembly, but then drops at most `max_refs` of the unused ones, stopping
+ * early once `max_time_nanos` has elapsed. Running finalizers is usually most
+ * of the cost of a collection, so calling this regularly with a small budget
+ * keeps pauses short. References which aren't dropped are kept for later
+ * steps or collections.
+ */
+WASM_API_EXTERN void wasmtime_context_gc_step(
+    wasmtime_context_t* context,
+    size_t max_refs,
+    uint64_t max_time_nanos,
+    wasmtime_gc_stats_t *stats);
+
+/**
+ * \brief Limits how many unused `externref`s each collection drops.
+ *
+ * This applies to #wasmtime_context_gc and to the collections which happen
+ * automatically once WebAssembly has used up the store's internal buffer of
+ * references, see #wasmtime_context_set_gc_trigger. References beyond the
+ * budget are kept until a later collection or #wasmtime_context_gc_step, which
+ * spreads the finalizers of a burst of references over several collections;
+ * `refs_pending` in #wasmtime_context_gc_stats reports how many are waiting.
+ *
+ * Nothing bounds the number of waiting references. If WebAssembly keeps
+ * handing over references faster than the budget lets collections drop them,
+ * the backlog and the memory it holds grow without limit, so hosts using a
+ * small budget should watch `refs_pending` and drain it with
+ * #wasmtime_context_gc_step or #wasmtime_context_gc.
+ *
+ * Passing `SIZE_MAX`, the default, drops every unused reference in each
+ * collection.
+ */
+WASM_API_EXTERN void wasmtime_context_set_gc_release_budget(
+    wasmtime_context_t* context,
+    size_t budget);
+
+/**
+ * \brief Sets how many `externref`s WebAssembly may receive before a
+ * collection is triggered automatically.
+ *
+ * Each `externref` passed to WebAssembly or read from a table or global by it
+ * takes an entry in an internal buffer, and a collection runs once the buffer
+ * is full. Larger values mean fewer automatic collections, at the cost of
+ * keeping unused references alive for longer. Values smaller than the default
+ * of 512 are rounded up. The new value takes effect after the next collection.
+ */
+WASM_API_EXTERN void wasmtime_context_set_gc_trigger(
+    wasmtime_context_t* context,
+    size_t entries);
+
+/**
+ * \brief Returns the totals of every garbage collection performed in this
+ * context's store so far, including automatic ones.
+ *
+ * `refs_pending` is the number of unused references currently waiting to be
+ * dropped.
+ */
+WASM_API_EXTERN void wasmtime_context_gc_stats(
+    const wasmtime_context_t* context,
+    wasmtime_gc_stats_t *stats);
+
 /**
  * \brief Adds fuel to this context's store for wasm to consume while executing.
  *
@@ -166,6 +471,21 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_context_consume_fuel(wasmtime_context
  */
 WASM_API_EXTERN wasmtime_error_t *wasmtime_context_set_wasi(wasmtime_context_t *context, wasi_config_t *wasi);
 
+/**
+ * \brief Configures WASI state within the specified store from a shared
+ * template.
+ *
+ * This behaves like #wasmtime_context_set_wasi but starts from `template_`,
+ * which isn't consumed and can be used for any number of stores. `overrides`
+ * may be `NULL`, and otherwise is applied on top of the template: arguments
+ * set in it replace the template's, environment variables and preopened
+ * directories are added to the template's, and its standard I/O settings are
+ * used for this store.
+ *
+ * This function takes ownership of `overrides` (even if an error is returned).
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_context_set_wasi_template(wasmtime_context_t *context, const wasi_template_t *template_, wasi_config_t *overrides);
+
 /**
  * \brief Configures the relative deadline at which point WebAssembly code will
  * trap.
@@ -118,6 +118,109 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_table_grow(
     uint32_t *prev_size
 );
 
+/**
+ * \brief Reads a range of an `externref` table into an array.
+ *
+ * \param store the store that owns `table`
+ * \param table the table to read from
+ * \param index the index of the first element to read
+ * \param out the array to fill in with `len` references
+ * \param len the number of elements to read
+ *
+ * This is equivalent to calling #wasmtime_table_get for each element, but
+ * takes a single call and adjusts reference counts once per run of identical
+ * references instead of once per element.
+ *
+ * On success each entry of `out` is either `NULL`, for a null reference, or
+ * an owned reference which must be released with #wasmtime_externref_delete.
+ * An error is returned if `table` doesn't hold `externref` values or if the
+ * range is out of bounds, in which case every entry of `out` is set to
+ * `NULL`.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_table_get_externrefs(
+    wasmtime_context_t *store,
+    const wasmtime_table_t *table,
+    uint32_t index,
+    wasmtime_externref_t **out,
+    size_t len
+);
+
+/**
+ * \brief Moves an array of references into a range of an `externref` table.
+ *
+ * \param store the store that owns `table`
+ * \param table the table to write to
+ * \param index the index of the first element to write
+ * \param vals the `len` references, each of which may be `NULL`
+ * \param len the number of elements to write
+ *
+ * Unlike #wasmtime_table_set this takes ownership of the references in
+ * `vals`, so they're moved into the table without touching their reference
+ * counts, and each entry of `vals` is set to `NULL` on success. The overwritten
+ * references are released once per run of identical references.
+ *
+ * An error is returned if `table` doesn't hold `externref` values or if the
+ * range is out of bounds, in which case `vals` is left as-is and its
+ * references are still owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_table_set_externrefs(
+    wasmtime_context_t *store,
+    const wasmtime_table_t *table,
+    uint32_t index,
+    wasmtime_externref_t **vals,
+    size_t len
+);
+
+/**
+ * \brief Fills a range of a table with a value.
+ *
+ * \param store the store that owns `table`
+ * \param table the table to fill
+ * \param index the index of the first element to fill
+ * \param val the value to store in each element
+ * \param len the number of elements to fill
+ *
+ * For `externref` tables the reference count of `val` is increased once for
+ * the whole range rather than once per element.
+ *
+ * An error is returned if `val` is the wrong type for this table or if the
+ * range is out of bounds. This function does not take ownership of any of
+ * its arguments.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_table_fill(
+    wasmtime_context_t *store,
+    const wasmtime_table_t *table,
+    uint32_t index,
+    const wasmtime_val_t *val,
+    uint32_t len
+);
+
+/**
+ * \brief Copies a range of elements from one table to another.
+ *
+ * \param store the store that owns both tables
+ * \param dst the table to copy into
+ * \param dst_index the index of the first element to write in `dst`
+ * \param src the table to copy from
+ * \param src_index the index of the first element to read in `src`
+ * \param len the number of elements to copy
+ *
+ * `dst` and `src` may be the same table and the ranges may overlap. For
+ * `externref` tables reference counts are adjusted once per run of identical
+ * references instead of once per element.
+ *
+ * An error is returned if the tables have different element types or if
+ * either range is out of bounds.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_table_copy(
+    wasmtime_context_t *store,
+    const wasmtime_table_t *dst,
+    uint32_t dst_index,
+    const wasmtime_table_t *src,
+    uint32_t src_index,
+    uint32_t len
+);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
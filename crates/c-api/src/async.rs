@@ -0,0 +1,336 @@
+use std::ffi::c_void;
+use std::future::Future;
+use std::mem::{self, MaybeUninit};
+use std::pin::Pin;
+use std::ptr;
+use std::str;
+use std::task::{Context, Poll, RawWaker, RawWakerVTable, Waker};
+
+use wasmtime::{AsContextMut, Caller, Func, Instance, Trap, Val};
+
+use crate::linker::to_str;
+use crate::{
+    bad_utf8, handle_result, translate_args, wasm_config_t, wasm_functype_t, wasm_trap_t,
+    wasmtime_caller_t, wasmtime_error_t, wasmtime_instance_pre_t, wasmtime_linker_t,
+    wasmtime_module_t, wasmtime_val_t, wasmtime_val_union, CStoreContextMut, WASMTIME_I32,
+};
+
+#[no_mangle]
+pub extern "C" fn wasmtime_config_async_support_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.async_support(enable);
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_config_async_stack_size_set(c: &mut wasm_config_t, size: usize) {
+    c.config.async_stack_size(size);
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_context_epoch_deadline_async_yield_and_update(
+    mut store: CStoreContextMut<'_>,
+    delta: u64,
+) {
+    store.epoch_deadline_async_yield_and_update(delta);
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_context_out_of_fuel_async_yield(
+    mut store: CStoreContextMut<'_>,
+    injection_count: u64,
+    fuel_to_inject: u64,
+) {
+    store.out_of_fuel_async_yield(injection_count, fuel_to_inject);
+}
+
+pub type wasmtime_func_async_callback_t = extern "C" fn(
+    *mut c_void,
+    *mut wasmtime_caller_t,
+    *const wasmtime_val_t,
+    usize,
+    *mut wasmtime_val_t,
+    usize,
+    &mut Option<Box<wasm_trap_t>>,
+    &mut wasmtime_async_continuation_t,
+);
+
+pub type wasmtime_func_async_continuation_callback_t = extern "C" fn(*mut c_void) -> bool;
+
+#[repr(C)]
+pub struct wasmtime_async_continuation_t {
+    pub callback: wasmtime_func_async_continuation_callback_t,
+    pub env: *mut c_void,
+    pub finalizer: Option<extern "C" fn(*mut c_void)>,
+}
+
+// The continuation is only ever polled from the thread driving the call
+// future, but it's held across an await point in a future which wasmtime
+// requires to be `Send`.
+unsafe impl Send for wasmtime_async_continuation_t {}
+unsafe impl Sync for wasmtime_async_continuation_t {}
+
+impl Drop for wasmtime_async_continuation_t {
+    fn drop(&mut self) {
+        if let Some(f) = self.finalizer {
+            f(self.env);
+        }
+    }
+}
+
+impl Future for wasmtime_async_continuation_t {
+    type Output = ();
+    fn poll(self: Pin<&mut Self>, _cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let this = self.get_mut();
+        if (this.callback)(this.env) {
+            Poll::Ready(())
+        } else {
+            Poll::Pending
+        }
+    }
+}
+
+/// Continuation used when the host callback doesn't fill one in, which
+/// completes immediately.
+extern "C" fn continuation_ready(_env: *mut c_void) -> bool {
+    true
+}
+
+/// Internal structure to add Send/Sync to the C-provided callback data.
+struct CallbackDataPtr {
+    ptr: *mut c_void,
+}
+
+unsafe impl Send for CallbackDataPtr {}
+unsafe impl Sync for CallbackDataPtr {}
+
+async fn invoke_c_async_callback<'a>(
+    callback: wasmtime_func_async_callback_t,
+    data: CallbackDataPtr,
+    mut caller: Caller<'a, crate::StoreData>,
+    params: &'a [Val],
+    results: &'a mut [Val],
+) -> Result<(), Trap> {
+    // Convert `params/results` to `wasmtime_val_t`, reusing the storage in
+    // `hostcall_val_storage` like synchronous host calls do.
+    let mut vals = mem::take(&mut caller.data_mut().hostcall_val_storage);
+    debug_assert!(vals.is_empty());
+    vals.reserve(params.len() + results.len());
+    vals.extend(params.iter().cloned().map(|p| wasmtime_val_t::from_val(p)));
+    vals.extend((0..results.len()).map(|_| wasmtime_val_t {
+        kind: WASMTIME_I32,
+        of: wasmtime_val_union { i32: 0 },
+    }));
+    let (params, out_results) = vals.split_at_mut(params.len());
+
+    // Invoke the C function pointer, which either fails immediately with a
+    // trap or hands back a continuation to wait on for the results.
+    let mut trap = None;
+    let mut continuation = wasmtime_async_continuation_t {
+        callback: continuation_ready,
+        env: ptr::null_mut(),
+        finalizer: None,
+    };
+    let mut caller = wasmtime_caller_t { caller };
+    callback(
+        data.ptr,
+        &mut caller,
+        params.as_ptr(),
+        params.len(),
+        out_results.as_mut_ptr(),
+        out_results.len(),
+        &mut trap,
+        &mut continuation,
+    );
+    let result = match trap {
+        Some(trap) => Err(trap.trap),
+        None => {
+            continuation.await;
+            for (i, result) in out_results.iter().enumerate() {
+                results[i] = unsafe { result.to_val() };
+            }
+            Ok(())
+        }
+    };
+
+    // Hand the storage back on every path, so a trapping host function
+    // doesn't make the next call allocate it again.
+    vals.truncate(0);
+    caller.caller.data_mut().hostcall_val_storage = vals;
+    result
+}
+
+unsafe fn c_async_callback_to_rust_fn(
+    callback: wasmtime_func_async_callback_t,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) -> impl for<'a> Fn(
+    Caller<'a, crate::StoreData>,
+    &'a [Val],
+    &'a mut [Val],
+) -> Box<dyn Future<Output = Result<(), Trap>> + Send + 'a>
+       + Send
+       + Sync
+       + 'static {
+    let foreign = crate::ForeignData { data, finalizer };
+    move |caller, params, results| {
+        drop(&foreign); // move entire foreign into this closure
+        let data = CallbackDataPtr { ptr: foreign.data };
+        Box::new(invoke_c_async_callback(
+            callback, data, caller, params, results,
+        ))
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_linker_define_async_func(
+    linker: &mut wasmtime_linker_t,
+    module: *const u8,
+    module_len: usize,
+    name: *const u8,
+    name_len: usize,
+    ty: &wasm_functype_t,
+    callback: wasmtime_func_async_callback_t,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) -> Option<Box<wasmtime_error_t>> {
+    let ty = ty.ty().ty.clone();
+    let module = to_str!(module, module_len);
+    let name = to_str!(name, name_len);
+    let cb = c_async_callback_to_rust_fn(callback, data, finalizer);
+    handle_result(
+        linker.linker.func_new_async(module, name, ty, cb),
+        |_linker| (),
+    )
+}
+
+pub struct wasmtime_call_future_t<'a> {
+    underlying: Pin<Box<dyn Future<Output = ()> + 'a>>,
+}
+
+wasmtime_c_api_macros::declare_own!(wasmtime_call_future_t);
+
+#[no_mangle]
+pub extern "C" fn wasmtime_call_future_poll(future: &mut wasmtime_call_future_t) -> bool {
+    let waker = noop_waker();
+    let mut cx = Context::from_waker(&waker);
+    match future.underlying.as_mut().poll(&mut cx) {
+        Poll::Ready(()) => true,
+        Poll::Pending => false,
+    }
+}
+
+/// The C API is driven by polling, so nothing needs to be woken up.
+fn noop_waker() -> Waker {
+    const VTABLE: RawWakerVTable = RawWakerVTable::new(clone, noop, noop, noop);
+    unsafe fn clone(_: *const ()) -> RawWaker {
+        RawWaker::new(ptr::null(), &VTABLE)
+    }
+    unsafe fn noop(_: *const ()) {}
+    unsafe { Waker::from_raw(RawWaker::new(ptr::null(), &VTABLE)) }
+}
+
+fn handle_call_error(
+    err: anyhow::Error,
+    trap_ret: &mut *mut wasm_trap_t,
+    err_ret: &mut *mut wasmtime_error_t,
+) {
+    match err.downcast::<Trap>() {
+        Ok(trap) => *trap_ret = Box::into_raw(Box::new(wasm_trap_t::new(trap))),
+        Err(err) => *err_ret = Box::into_raw(Box::new(wasmtime_error_t::from(err))),
+    }
+}
+
+async fn do_func_call_async(
+    mut store: CStoreContextMut<'_>,
+    func: &Func,
+    args: Vec<Val>,
+    results: &mut [MaybeUninit<wasmtime_val_t>],
+    trap_ret: &mut *mut wasm_trap_t,
+    err_ret: &mut *mut wasmtime_error_t,
+) {
+    let mut store = store.as_context_mut();
+    let mut params = mem::take(&mut store.data_mut().wasm_val_storage);
+    let (wt_params, wt_results) = translate_args(&mut params, args.into_iter(), results.len());
+    match func.call_async(&mut store, wt_params, wt_results).await {
+        Ok(()) => {
+            for (slot, val) in results.iter_mut().zip(wt_results.iter()) {
+                crate::initialize(slot, wasmtime_val_t::from_val(val.clone()));
+            }
+        }
+        Err(err) => handle_call_error(err, trap_ret, err_ret),
+    }
+    params.truncate(0);
+    store.data_mut().wasm_val_storage = params;
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_func_call_async<'a>(
+    store: CStoreContextMut<'a>,
+    func: &'a Func,
+    args: *const wasmtime_val_t,
+    nargs: usize,
+    results: *mut MaybeUninit<wasmtime_val_t>,
+    nresults: usize,
+    trap_ret: &'a mut *mut wasm_trap_t,
+    err_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    // Arguments are converted now so the caller's array only needs to live
+    // for the duration of this call, not the whole future.
+    let args = crate::slice_from_raw_parts(args, nargs)
+        .iter()
+        .map(|i| i.to_val())
+        .collect();
+    let results = crate::slice_from_raw_parts_mut(results, nresults);
+    let fut = Box::pin(do_func_call_async(
+        store, func, args, results, trap_ret, err_ret,
+    ));
+    Box::new(wasmtime_call_future_t { underlying: fut })
+}
+
+async fn do_instantiate_async(
+    instance: impl Future<Output = anyhow::Result<Instance>>,
+    instance_ptr: &mut Instance,
+    trap_ret: &mut *mut wasm_trap_t,
+    err_ret: &mut *mut wasmtime_error_t,
+) {
+    match instance.await {
+        Ok(instance) => *instance_ptr = instance,
+        Err(err) => handle_call_error(err, trap_ret, err_ret),
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_linker_instantiate_async<'a>(
+    linker: &'a wasmtime_linker_t,
+    store: CStoreContextMut<'a>,
+    module: &'a wasmtime_module_t,
+    instance_ptr: &'a mut Instance,
+    trap_ret: &'a mut *mut wasm_trap_t,
+    err_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    let instance = linker.linker.instantiate_async(store, &module.module);
+    let fut = Box::pin(do_instantiate_async(
+        instance,
+        instance_ptr,
+        trap_ret,
+        err_ret,
+    ));
+    Box::new(wasmtime_call_future_t { underlying: fut })
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_instance_pre_instantiate_async<'a>(
+    instance_pre: &'a wasmtime_instance_pre_t,
+    store: CStoreContextMut<'a>,
+    instance_ptr: &'a mut Instance,
+    trap_ret: &'a mut *mut wasm_trap_t,
+    err_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    let instance = instance_pre.underlying.instantiate_async(store);
+    let fut = Box::pin(do_instantiate_async(
+        instance,
+        instance_ptr,
+        trap_ret,
+        err_ret,
+    ));
+    Box::new(wasmtime_call_future_t { underlying: fut })
+}
@@ -3,14 +3,55 @@
 #![cfg_attr(not(feature = "cache"), allow(unused_imports))]
 
 use crate::{handle_result, wasmtime_error_t};
-use std::ffi::CStr;
+use std::ffi::{c_void, CStr};
 use std::os::raw::c_char;
+#[cfg(feature = "parallel-compilation")]
+use std::sync::Arc;
 use wasmtime::{Config, OptLevel, ProfilingStrategy, Strategy};
+#[cfg(feature = "pooling-allocator")]
+use wasmtime::{InstanceAllocationStrategy, InstanceLimits, PoolingAllocationStrategy};
 
 #[repr(C)]
 #[derive(Clone)]
 pub struct wasm_config_t {
     pub(crate) config: Config,
+
+    /// Limits for the pooling allocator, kept here since `Config` can't be
+    /// queried and each limit is set through its own C function.
+    #[cfg(feature = "pooling-allocator")]
+    pub(crate) pooling: Option<InstanceLimits>,
+
+    /// Settings for the compilation thread pool, applied when the engine is
+    /// created since they configure a pool rather than the `Config`.
+    #[cfg(feature = "parallel-compilation")]
+    pub(crate) compile_threads: usize,
+    #[cfg(feature = "parallel-compilation")]
+    pub(crate) compile_spawn: Option<Arc<CompileSpawn>>,
+}
+
+pub type wasmtime_compile_task_t = extern "C" fn(*mut c_void);
+
+pub type wasmtime_compile_spawn_callback_t =
+    extern "C" fn(*mut c_void, wasmtime_compile_task_t, *mut c_void) -> bool;
+
+/// A caller-provided function for starting compilation worker threads.
+#[cfg(feature = "parallel-compilation")]
+pub(crate) struct CompileSpawn {
+    pub(crate) callback: wasmtime_compile_spawn_callback_t,
+    pub(crate) foreign: crate::ForeignData,
+}
+
+impl wasm_config_t {
+    #[cfg(feature = "pooling-allocator")]
+    fn update_pooling(&mut self, f: impl FnOnce(&mut InstanceLimits)) {
+        let limits = self.pooling.get_or_insert_with(InstanceLimits::default);
+        f(limits);
+        self.config
+            .allocation_strategy(InstanceAllocationStrategy::Pooling {
+                strategy: PoolingAllocationStrategy::default(),
+                instance_limits: *limits,
+            });
+    }
 }
 
 wasmtime_c_api_macros::declare_own!(wasm_config_t);
@@ -42,6 +83,12 @@ pub enum wasmtime_profiling_strategy_t {
 pub extern "C" fn wasm_config_new() -> Box<wasm_config_t> {
     Box::new(wasm_config_t {
         config: Config::default(),
+        #[cfg(feature = "pooling-allocator")]
+        pooling: None,
+        #[cfg(feature = "parallel-compilation")]
+        compile_threads: 0,
+        #[cfg(feature = "parallel-compilation")]
+        compile_spawn: None,
     })
 }
 
@@ -50,6 +97,17 @@ pub extern "C" fn wasmtime_config_debug_info_set(c: &mut wasm_config_t, enable:
     c.config.debug_info(enable);
 }
 
+#[no_mangle]
+#[allow(deprecated)]
+pub extern "C" fn wasmtime_config_wasm_backtrace_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.wasm_backtrace(enable);
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_config_wasm_backtrace_lazy_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.wasm_backtrace_lazy(enable);
+}
+
 #[no_mangle]
 pub extern "C" fn wasmtime_config_consume_fuel_set(c: &mut wasm_config_t, enable: bool) {
     c.config.consume_fuel(enable);
@@ -187,3 +245,90 @@ pub extern "C" fn wasmtime_config_static_memory_guard_size_set(c: &mut wasm_conf
 pub extern "C" fn wasmtime_config_dynamic_memory_guard_size_set(c: &mut wasm_config_t, size: u64) {
     c.config.dynamic_memory_guard_size(size);
 }
+
+#[no_mangle]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_config_allocation_strategy_pooling(c: &mut wasm_config_t) {
+    c.update_pooling(|_| {});
+}
+
+#[no_mangle]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_config_pooling_instance_count_set(c: &mut wasm_config_t, count: u32) {
+    c.update_pooling(|limits| limits.count = count);
+}
+
+#[no_mangle]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_config_pooling_instance_size_set(c: &mut wasm_config_t, size: usize) {
+    c.update_pooling(|limits| limits.size = size);
+}
+
+#[no_mangle]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_config_pooling_max_tables_set(c: &mut wasm_config_t, tables: u32) {
+    c.update_pooling(|limits| limits.tables = tables);
+}
+
+#[no_mangle]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_config_pooling_table_elements_set(c: &mut wasm_config_t, elements: u32) {
+    c.update_pooling(|limits| limits.table_elements = elements);
+}
+
+#[no_mangle]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_config_pooling_max_memories_set(c: &mut wasm_config_t, memories: u32) {
+    c.update_pooling(|limits| limits.memories = memories);
+}
+
+#[no_mangle]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_config_pooling_memory_pages_set(c: &mut wasm_config_t, pages: u64) {
+    c.update_pooling(|limits| limits.memory_pages = pages);
+}
+
+#[no_mangle]
+#[cfg(feature = "memory-init-cow")]
+pub extern "C" fn wasmtime_config_memory_init_cow_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.memory_init_cow(enable);
+}
+
+#[no_mangle]
+#[cfg(feature = "memory-init-cow")]
+pub extern "C" fn wasmtime_config_force_memory_init_memfd_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.force_memory_init_memfd(enable);
+}
+
+#[no_mangle]
+#[cfg(feature = "memory-init-cow")]
+pub extern "C" fn wasmtime_config_memory_guaranteed_dense_image_size_set(
+    c: &mut wasm_config_t,
+    size: u64,
+) {
+    c.config.memory_guaranteed_dense_image_size(size);
+}
+
+#[no_mangle]
+#[cfg(feature = "parallel-compilation")]
+pub extern "C" fn wasmtime_config_parallel_compilation_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.parallel_compilation(enable);
+}
+
+#[no_mangle]
+#[cfg(feature = "parallel-compilation")]
+pub extern "C" fn wasmtime_config_compilation_threads_set(c: &mut wasm_config_t, threads: usize) {
+    c.compile_threads = threads;
+}
+
+#[no_mangle]
+#[cfg(feature = "parallel-compilation")]
+pub extern "C" fn wasmtime_config_compilation_spawn_set(
+    c: &mut wasm_config_t,
+    callback: Option<wasmtime_compile_spawn_callback_t>,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) {
+    let foreign = crate::ForeignData { data, finalizer };
+    c.compile_spawn = callback.map(|callback| Arc::new(CompileSpawn { callback, foreign }));
+}
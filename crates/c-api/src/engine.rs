@@ -1,14 +1,65 @@
 use crate::wasm_config_t;
+#[cfg(feature = "parallel-compilation")]
+use std::sync::Arc;
 use wasmtime::Engine;
 
 #[repr(C)]
 #[derive(Clone)]
 pub struct wasm_engine_t {
     pub(crate) engine: Engine,
+
+    /// Dedicated thread pool for compilation, if the config asked for a
+    /// specific number of threads or a custom way to spawn them. Otherwise
+    /// compilation uses rayon's global pool.
+    #[cfg(feature = "parallel-compilation")]
+    pub(crate) compile_pool: Option<Arc<rayon::ThreadPool>>,
 }
 
 wasmtime_c_api_macros::declare_own!(wasm_engine_t);
 
+impl wasm_engine_t {
+    /// Runs `f`, which compiles or validates a module, on this engine's
+    /// compilation thread pool.
+    pub(crate) fn compile<R: Send>(&self, f: impl FnOnce() -> R + Send) -> R {
+        #[cfg(feature = "parallel-compilation")]
+        if let Some(pool) = &self.compile_pool {
+            return pool.install(f);
+        }
+        f()
+    }
+}
+
+#[cfg(feature = "parallel-compilation")]
+fn compile_pool(c: &wasm_config_t) -> Option<Arc<rayon::ThreadPool>> {
+    use crate::CompileSpawn;
+
+    extern "C" fn run_worker(task: *mut std::ffi::c_void) {
+        let thread = unsafe { Box::from_raw(task.cast::<rayon::ThreadBuilder>()) };
+        thread.run();
+    }
+
+    if c.compile_threads == 0 && c.compile_spawn.is_none() {
+        return None;
+    }
+    let mut builder = rayon::ThreadPoolBuilder::new().num_threads(c.compile_threads);
+    if let Some(spawn) = c.compile_spawn.clone() {
+        builder = builder.spawn_handler(move |thread| {
+            let CompileSpawn { callback, foreign } = &*spawn;
+            let task = Box::into_raw(Box::new(thread));
+            if callback(foreign.data, run_worker, task.cast()) {
+                Ok(())
+            } else {
+                drop(unsafe { Box::from_raw(task) });
+                Err(std::io::Error::new(
+                    std::io::ErrorKind::Other,
+                    "failed to spawn compilation thread",
+                ))
+            }
+        });
+    }
+    builder.build().ok().map(Arc::new)
+}
+
 #[no_mangle]
 pub extern "C" fn wasm_engine_new() -> Box<wasm_engine_t> {
     // Enable the `env_logger` crate since this is as good a place as any to
@@ -23,14 +74,29 @@ pub extern "C" fn wasm_engine_new() -> Box<wasm_engine_t> {
 
     Box::new(wasm_engine_t {
         engine: Engine::default(),
+        #[cfg(feature = "parallel-compilation")]
+        compile_pool: None,
     })
 }
 
 #[no_mangle]
 pub extern "C" fn wasm_engine_new_with_config(c: Box<wasm_config_t>) -> Box<wasm_engine_t> {
-    let config = c.config;
+    #[cfg(feature = "parallel-compilation")]
+    let (c, compile_pool) = {
+        let mut c = c;
+        let pool = compile_pool(&c);
+        // The embedder asked to control compilation threads but they couldn't
+        // be started, so compile on the calling thread rather than quietly
+        // using threads it didn't ask for.
+        if pool.is_none() && (c.compile_threads != 0 || c.compile_spawn.is_some()) {
+            c.config.parallel_compilation(false);
+        }
+        (c, pool)
+    };
     Box::new(wasm_engine_t {
-        engine: Engine::new(&config).unwrap(),
+        engine: Engine::new(&c.config).unwrap(),
+        #[cfg(feature = "parallel-compilation")]
+        compile_pool,
     })
 }
 
@@ -3,12 +3,13 @@ use crate::{
     wasm_extern_t, wasm_functype_t, wasm_store_t, wasm_val_t, wasm_val_vec_t, wasmtime_error_t,
     wasmtime_extern_t, wasmtime_val_t, wasmtime_val_union, CStoreContext, CStoreContextMut,
 };
+use anyhow::anyhow;
 use std::ffi::c_void;
 use std::mem::{self, MaybeUninit};
 use std::panic::{self, AssertUnwindSafe};
 use std::ptr;
 use std::str;
-use wasmtime::{AsContextMut, Caller, Extern, Func, Trap, Val, ValRaw};
+use wasmtime::{AsContextMut, Caller, Extern, Func, Trap, Val, ValRaw, ValType};
 
 #[derive(Clone)]
 #[repr(transparent)]
@@ -111,7 +112,7 @@ pub unsafe extern "C" fn wasm_func_new_with_env(
 
 /// Places the `args` into `dst` and additionally reserves space in `dst` for `results_size`
 /// returns. The params/results slices are then returned separately.
-fn translate_args<'a>(
+pub(crate) fn translate_args<'a>(
     dst: &'a mut Vec<Val>,
     args: impl ExactSizeIterator<Item = Val>,
     results_size: usize,
@@ -197,7 +198,7 @@ pub extern "C" fn wasm_func_as_extern_const(f: &wasm_func_t) -> &wasm_extern_t {
 
 #[repr(C)]
 pub struct wasmtime_caller_t<'a> {
-    caller: Caller<'a, crate::StoreData>,
+    pub(crate) caller: Caller<'a, crate::StoreData>,
 }
 
 pub type wasmtime_func_callback_t = extern "C" fn(
@@ -313,6 +314,43 @@ pub(crate) unsafe fn c_unchecked_callback_to_rust_fn(
 
 #[no_mangle]
 pub unsafe extern "C" fn wasmtime_func_call(
+    store: CStoreContextMut<'_>,
+    func: &Func,
+    args: *const wasmtime_val_t,
+    nargs: usize,
+    results: *mut MaybeUninit<wasmtime_val_t>,
+    nresults: usize,
+    trap_ret: &mut *mut wasm_trap_t,
+) -> Option<Box<wasmtime_error_t>> {
+    do_func_call(store, func, args, nargs, results, nresults, trap_ret, None)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_func_call_with_exit(
+    store: CStoreContextMut<'_>,
+    func: &Func,
+    args: *const wasmtime_val_t,
+    nargs: usize,
+    results: *mut MaybeUninit<wasmtime_val_t>,
+    nresults: usize,
+    trap_ret: &mut *mut wasm_trap_t,
+    exited: &mut bool,
+    exit_status: &mut i32,
+) -> Option<Box<wasmtime_error_t>> {
+    *exited = false;
+    do_func_call(
+        store,
+        func,
+        args,
+        nargs,
+        results,
+        nresults,
+        trap_ret,
+        Some((exited, exit_status)),
+    )
+}
+
+unsafe fn do_func_call(
     mut store: CStoreContextMut<'_>,
     func: &Func,
     args: *const wasmtime_val_t,
@@ -320,6 +358,7 @@ pub unsafe extern "C" fn wasmtime_func_call(
     results: *mut MaybeUninit<wasmtime_val_t>,
     nresults: usize,
     trap_ret: &mut *mut wasm_trap_t,
+    exit_ret: Option<(&mut bool, &mut i32)>,
 ) -> Option<Box<wasmtime_error_t>> {
     let mut store = store.as_context_mut();
     let mut params = mem::take(&mut store.data_mut().wasm_val_storage);
@@ -350,6 +389,15 @@ pub unsafe extern "C" fn wasmtime_func_call(
         }
         Ok(Err(trap)) => match trap.downcast::<Trap>() {
             Ok(trap) => {
+                // Explicit exits are reported without boxing up a trap when
+                // the caller asked for them separately.
+                if let (Some((exited, exit_status)), Some(status)) =
+                    (exit_ret, trap.i32_exit_status())
+                {
+                    *exited = true;
+                    *exit_status = status;
+                    return None;
+                }
                 *trap_ret = Box::into_raw(Box::new(wasm_trap_t::new(trap)));
                 None
             }
@@ -381,6 +429,233 @@ pub unsafe extern "C" fn wasmtime_func_call_unchecked(
     }
 }
 
+/// Returns the `wasmtime_valkind_t` used for values of type `ty` when it can
+/// be passed through a `ValRaw` without touching the store, or `None` for
+/// reference types.
+fn raw_valkind(ty: &ValType) -> Option<crate::wasmtime_valkind_t> {
+    match ty {
+        ValType::I32 => Some(crate::WASMTIME_I32),
+        ValType::I64 => Some(crate::WASMTIME_I64),
+        ValType::F32 => Some(crate::WASMTIME_F32),
+        ValType::F64 => Some(crate::WASMTIME_F64),
+        ValType::V128 => Some(crate::WASMTIME_V128),
+        ValType::FuncRef | ValType::ExternRef => None,
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_func_call_batch(
+    mut store: CStoreContextMut<'_>,
+    func: &Func,
+    args: *const wasmtime_val_t,
+    nargs: usize,
+    results: *mut MaybeUninit<wasmtime_val_t>,
+    nresults: usize,
+    nbatch: usize,
+    trap_index: &mut usize,
+    trap_ret: &mut *mut wasm_trap_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let mut store = store.as_context_mut();
+    *trap_index = 0;
+    if !func.belongs_to(&store) {
+        return Some(Box::new(wrong_store().into()));
+    }
+    let ty = func.ty(&store);
+    if ty.params().len() != nargs || ty.results().len() != nresults {
+        return Some(Box::new(
+            anyhow!(
+                "function takes {} parameters and {} results, not {} and {}",
+                ty.params().len(),
+                ty.results().len(),
+                nargs,
+                nresults
+            )
+            .into(),
+        ));
+    }
+    let (total_args, total_results) =
+        match (nargs.checked_mul(nbatch), nresults.checked_mul(nbatch)) {
+            (Some(a), Some(r)) => (a, r),
+            _ => {
+                return Some(Box::new(
+                    anyhow!("batch of {} calls is too large", nbatch).into(),
+                ))
+            }
+        };
+    let args = crate::slice_from_raw_parts(args, total_args);
+    let results = crate::slice_from_raw_parts_mut(results, total_results);
+
+    // Functions with only numeric parameters and results have their arguments
+    // checked once up front and are then driven through `call_unchecked` with a
+    // single reused buffer. Reference types need the store-aware checks in
+    // `Func::call`, so those fall back to the checked path per element.
+    let params = ty
+        .params()
+        .map(|t| raw_valkind(&t))
+        .collect::<Option<Vec<_>>>();
+    let rets = ty.results().collect::<Vec<_>>();
+    let raw = params.is_some() && rets.iter().all(|t| raw_valkind(t).is_some());
+    if let Some(params) = params.as_ref().filter(|_| raw) {
+        for (i, arg) in args.iter().enumerate() {
+            if arg.kind != params[i % nargs] {
+                return Some(Box::new(
+                    anyhow!(
+                        "argument {} of call {} has the wrong type",
+                        i % nargs,
+                        i / nargs
+                    )
+                    .into(),
+                ));
+            }
+        }
+    }
+
+    let mut storage = mem::take(&mut store.data_mut().wasm_val_storage);
+    let mut space = vec![ValRaw::i32(0); nargs.max(nresults)];
+    let mut done = 0;
+    let result = panic::catch_unwind(AssertUnwindSafe(|| {
+        for i in 0..nbatch {
+            let args = &args[i * nargs..][..nargs];
+            let results = &mut results[i * nresults..][..nresults];
+            if raw {
+                for (slot, arg) in space.iter_mut().zip(args) {
+                    *slot = arg.to_val().to_raw(&mut store);
+                }
+                func.call_unchecked(&mut store, space.as_mut_ptr())?;
+                for ((slot, raw), ty) in results.iter_mut().zip(&space).zip(&rets) {
+                    let val = Val::from_raw(&mut store, *raw, ty.clone());
+                    crate::initialize(slot, wasmtime_val_t::from_val(val));
+                }
+            } else {
+                let (wt_params, wt_results) =
+                    translate_args(&mut storage, args.iter().map(|i| i.to_val()), nresults);
+                func.call(&mut store, wt_params, wt_results)?;
+                for (slot, val) in results.iter_mut().zip(wt_results.iter()) {
+                    crate::initialize(slot, wasmtime_val_t::from_val(val.clone()));
+                }
+                storage.truncate(0);
+            }
+            done += 1;
+        }
+        Ok::<(), anyhow::Error>(())
+    }));
+    *trap_index = done;
+    let result = match result {
+        Ok(Ok(())) => None,
+        Ok(Err(trap)) => match trap.downcast::<Trap>() {
+            Ok(trap) => {
+                *trap_ret = Box::into_raw(Box::new(wasm_trap_t::new(trap)));
+                None
+            }
+            Err(err) => Some(Box::new(wasmtime_error_t::from(err))),
+        },
+        Err(panic) => {
+            let trap = if let Some(msg) = panic.downcast_ref::<String>() {
+                Trap::new(msg)
+            } else if let Some(msg) = panic.downcast_ref::<&'static str>() {
+                Trap::new(*msg)
+            } else {
+                Trap::new("rust panic happened")
+            };
+            *trap_ret = Box::into_raw(Box::new(wasm_trap_t::new(trap)));
+            None
+        }
+    };
+    storage.truncate(0);
+    store.data_mut().wasm_val_storage = storage;
+    result
+}
+
+#[repr(C)]
+pub struct wasmtime_typed_func_t {
+    func: Func,
+    nparams: usize,
+    nresults: usize,
+}
+
+/// Character used for `ty` in the signature strings of typed functions.
+fn signature_char(ty: ValType) -> char {
+    match ty {
+        ValType::I32 => 'i',
+        ValType::I64 => 'I',
+        ValType::F32 => 'f',
+        ValType::F64 => 'F',
+        ValType::V128 => 'v',
+        ValType::FuncRef => 'r',
+        ValType::ExternRef => 'e',
+    }
+}
+
+fn wrong_store() -> anyhow::Error {
+    anyhow!("function is not owned by this store")
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_func_typed(
+    store: CStoreContext<'_>,
+    func: &Func,
+    signature: *const u8,
+    signature_len: usize,
+    typed: &mut MaybeUninit<wasmtime_typed_func_t>,
+) -> Option<Box<wasmtime_error_t>> {
+    let signature = match str::from_utf8(crate::slice_from_raw_parts(signature, signature_len)) {
+        Ok(s) => s,
+        Err(_) => return crate::bad_utf8(),
+    };
+    if !func.belongs_to(&store) {
+        return Some(Box::new(wrong_store().into()));
+    }
+    let ty = func.ty(store);
+    let actual = ty
+        .params()
+        .map(signature_char)
+        .chain(Some(':'))
+        .chain(ty.results().map(signature_char))
+        .collect::<String>();
+    if signature != actual {
+        return Some(Box::new(
+            anyhow!("function has signature `{}`, not `{}`", actual, signature).into(),
+        ));
+    }
+    crate::initialize(
+        typed,
+        wasmtime_typed_func_t {
+            func: *func,
+            nparams: ty.params().len(),
+            nresults: ty.results().len(),
+        },
+    );
+    None
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_typed_func_call(
+    store: CStoreContextMut<'_>,
+    typed: &wasmtime_typed_func_t,
+    args_and_results: *mut ValRaw,
+    args_and_results_len: usize,
+    trap_ret: &mut *mut wasm_trap_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let needed = typed.nparams.max(typed.nresults);
+    if args_and_results_len < needed {
+        return Some(Box::new(
+            anyhow!(
+                "argument and result buffer holds {} values but {} are needed",
+                args_and_results_len,
+                needed
+            )
+            .into(),
+        ));
+    }
+    if !typed.func.belongs_to(&store) {
+        return Some(Box::new(wrong_store().into()));
+    }
+    if let Err(trap) = typed.func.call_unchecked(store, args_and_results) {
+        *trap_ret = Box::into_raw(Box::new(wasm_trap_t::new(trap)));
+    }
+    None
+}
+
 #[no_mangle]
 pub extern "C" fn wasmtime_func_type(
     store: CStoreContext<'_>,
@@ -3,7 +3,7 @@ use crate::{
     wasmtime_extern_t, wasmtime_module_t, CStoreContextMut, StoreRef,
 };
 use std::mem::MaybeUninit;
-use wasmtime::{Instance, Trap};
+use wasmtime::{Instance, InstancePre, Trap};
 
 #[derive(Clone)]
 pub struct wasm_instance_t {
@@ -108,6 +108,24 @@ pub(crate) fn handle_instantiate(
     }
 }
 
+#[repr(transparent)]
+pub struct wasmtime_instance_pre_t {
+    pub(crate) underlying: InstancePre<crate::StoreData>,
+}
+
+wasmtime_c_api_macros::declare_own!(wasmtime_instance_pre_t);
+
+#[no_mangle]
+pub extern "C" fn wasmtime_instance_pre_instantiate(
+    instance_pre: &wasmtime_instance_pre_t,
+    store: CStoreContextMut<'_>,
+    instance_ptr: &mut Instance,
+    trap_ptr: &mut *mut wasm_trap_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = instance_pre.underlying.instantiate(store);
+    handle_instantiate(result, instance_ptr, trap_ptr)
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn wasmtime_instance_export_get(
     store: CStoreContextMut<'_>,
@@ -149,3 +167,30 @@ pub unsafe extern "C" fn wasmtime_instance_export_nth(
         None => false,
     }
 }
+
+#[no_mangle]
+pub extern "C" fn wasmtime_instance_reset(
+    mut store: CStoreContextMut<'_>,
+    instance: &Instance,
+    trap_ptr: &mut *mut wasm_trap_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let usage = store.data().limiter.usage.clone();
+    let before = store.memory_stats(false);
+    let result = instance.reset(&mut store);
+    // Memories may have been reset even if a later step failed.
+    let after = store.memory_stats(false);
+    store
+        .data_mut()
+        .limiter
+        .instance_reset(usage, &before, &after);
+    match result {
+        Ok(()) => None,
+        Err(e) => match e.downcast::<Trap>() {
+            Ok(trap) => {
+                *trap_ptr = Box::into_raw(Box::new(wasm_trap_t::new(trap)));
+                None
+            }
+            Err(e) => Some(Box::new(e.into())),
+        },
+    }
+}
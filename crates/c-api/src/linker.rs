@@ -1,15 +1,16 @@
 use crate::{
     bad_utf8, handle_result, wasm_engine_t, wasm_functype_t, wasm_trap_t, wasmtime_error_t,
-    wasmtime_extern_t, wasmtime_module_t, CStoreContextMut,
+    wasmtime_extern_t, wasmtime_instance_pre_t, wasmtime_module_t, CStoreContextMut,
 };
 use std::ffi::c_void;
 use std::mem::MaybeUninit;
 use std::str;
+use std::sync::Arc;
 use wasmtime::{Func, Instance, Linker};
 
 #[repr(C)]
 pub struct wasmtime_linker_t {
-    linker: Linker<crate::StoreData>,
+    pub(crate) linker: Linker<crate::StoreData>,
 }
 
 wasmtime_c_api_macros::declare_own!(wasmtime_linker_t);
@@ -38,6 +39,8 @@ macro_rules! to_str {
     };
 }
 
+pub(crate) use to_str;
+
 #[no_mangle]
 pub unsafe extern "C" fn wasmtime_linker_define(
     linker: &mut wasmtime_linker_t,
@@ -131,6 +134,19 @@ pub extern "C" fn wasmtime_linker_instantiate(
     super::instance::handle_instantiate(result, instance_ptr, trap_ptr)
 }
 
+#[no_mangle]
+pub extern "C" fn wasmtime_linker_instantiate_pre(
+    linker: &wasmtime_linker_t,
+    store: CStoreContextMut<'_>,
+    module: &wasmtime_module_t,
+    instance_pre: &mut *mut wasmtime_instance_pre_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = linker.linker.instantiate_pre(store, &module.module);
+    handle_result(result, |underlying| {
+        *instance_pre = Box::into_raw(Box::new(wasmtime_instance_pre_t { underlying }));
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn wasmtime_linker_module(
     linker: &mut wasmtime_linker_t,
@@ -184,3 +200,54 @@ pub unsafe extern "C" fn wasmtime_linker_get(
         None => false,
     }
 }
+
+/// An immutable snapshot of a `wasmtime_linker_t` which can be shared between
+/// threads and used concurrently without any locking.
+#[repr(C)]
+#[derive(Clone)]
+pub struct wasmtime_frozen_linker_t {
+    linker: Arc<Linker<crate::StoreData>>,
+}
+
+wasmtime_c_api_macros::declare_own!(wasmtime_frozen_linker_t);
+
+#[no_mangle]
+pub extern "C" fn wasmtime_linker_freeze(
+    linker: &wasmtime_linker_t,
+) -> Box<wasmtime_frozen_linker_t> {
+    Box::new(wasmtime_frozen_linker_t {
+        linker: Arc::new(linker.linker.clone()),
+    })
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_frozen_linker_clone(
+    linker: &wasmtime_frozen_linker_t,
+) -> Box<wasmtime_frozen_linker_t> {
+    Box::new(linker.clone())
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_frozen_linker_instantiate(
+    linker: &wasmtime_frozen_linker_t,
+    store: CStoreContextMut<'_>,
+    module: &wasmtime_module_t,
+    instance_ptr: &mut Instance,
+    trap_ptr: &mut *mut wasm_trap_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = linker.linker.instantiate(store, &module.module);
+    super::instance::handle_instantiate(result, instance_ptr, trap_ptr)
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_frozen_linker_instantiate_pre(
+    linker: &wasmtime_frozen_linker_t,
+    store: CStoreContextMut<'_>,
+    module: &wasmtime_module_t,
+    instance_pre: &mut *mut wasmtime_instance_pre_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = linker.linker.instantiate_pre(store, &module.module);
+    handle_result(result, |underlying| {
+        *instance_pre = Box::into_raw(Box::new(wasmtime_instance_pre_t { underlying }));
+    })
+}
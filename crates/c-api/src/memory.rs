@@ -2,7 +2,10 @@ use crate::{
     handle_result, wasm_extern_t, wasm_memorytype_t, wasm_store_t, wasmtime_error_t, CStoreContext,
     CStoreContextMut,
 };
+use anyhow::{anyhow, Result};
 use std::convert::TryFrom;
+use std::mem::MaybeUninit;
+use std::ops::Range;
 use wasmtime::{Extern, Memory};
 
 #[derive(Clone)]
@@ -127,3 +130,158 @@ pub extern "C" fn wasmtime_memory_grow(
 ) -> Option<Box<wasmtime_error_t>> {
     handle_result(mem.grow(store, delta), |prev| *prev_size = prev)
 }
+
+#[repr(C)]
+pub struct wasmtime_memory_view_t {
+    pub base: *mut u8,
+    pub length: usize,
+    pub generation: u64,
+}
+
+fn memory_view(store: &CStoreContext<'_>, mem: &Memory) -> wasmtime_memory_view_t {
+    wasmtime_memory_view_t {
+        base: mem.data_ptr(store),
+        length: mem.data_size(store),
+        generation: store.data().limiter.memory_generation,
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_memory_view_get(
+    store: CStoreContext<'_>,
+    mem: &Memory,
+    view: &mut MaybeUninit<wasmtime_memory_view_t>,
+) {
+    crate::initialize(view, memory_view(&store, mem));
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_memory_view_refresh(
+    store: CStoreContext<'_>,
+    mem: &Memory,
+    view: &mut wasmtime_memory_view_t,
+) -> bool {
+    if view.generation == store.data().limiter.memory_generation {
+        return false;
+    }
+    *view = memory_view(&store, mem);
+    true
+}
+
+/// Returns the range `offset..offset + len` if it's entirely within a memory
+/// of `size` bytes, checking for overflow along the way.
+fn memory_range(size: usize, offset: u64, len: usize) -> Result<Range<usize>> {
+    usize::try_from(offset)
+        .ok()
+        .and_then(|start| Some(start..start.checked_add(len)?))
+        .filter(|range| range.end <= size)
+        .ok_or_else(|| anyhow!("out of bounds memory access"))
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_memory_read(
+    store: CStoreContext<'_>,
+    mem: &Memory,
+    offset: u64,
+    buf: *mut u8,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let data = mem.data(store);
+    handle_result(memory_range(data.len(), offset, len), |range| {
+        crate::slice_from_raw_parts_mut(buf, len).copy_from_slice(&data[range]);
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_memory_write(
+    store: CStoreContextMut<'_>,
+    mem: &Memory,
+    offset: u64,
+    buf: *const u8,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let data = mem.data_mut(store);
+    handle_result(memory_range(data.len(), offset, len), |range| {
+        data[range].copy_from_slice(crate::slice_from_raw_parts(buf, len));
+    })
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_memory_fill(
+    store: CStoreContextMut<'_>,
+    mem: &Memory,
+    offset: u64,
+    val: u8,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let data = mem.data_mut(store);
+    handle_result(memory_range(data.len(), offset, len), |range| {
+        data[range].fill(val);
+    })
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_memory_copy_within(
+    store: CStoreContextMut<'_>,
+    mem: &Memory,
+    dst: u64,
+    src: u64,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let data = mem.data_mut(store);
+    let ranges = memory_range(data.len(), src, len)
+        .and_then(|src| Ok((src, memory_range(data.len(), dst, len)?)));
+    handle_result(ranges, |(src, dst)| data.copy_within(src, dst.start))
+}
+
+#[repr(C)]
+pub struct wasmtime_memory_iovec_t {
+    pub offset: u64,
+    pub buf: *mut u8,
+    pub len: usize,
+}
+
+/// Checks every iovec against a memory of `size` bytes before any of them are
+/// used, so a failed scatter/gather doesn't leave a partial copy behind.
+fn check_iovecs(size: usize, iovs: &[wasmtime_memory_iovec_t]) -> Result<()> {
+    for iov in iovs {
+        memory_range(size, iov.offset, iov.len)?;
+    }
+    Ok(())
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_memory_readv(
+    store: CStoreContext<'_>,
+    mem: &Memory,
+    iovs: *const wasmtime_memory_iovec_t,
+    niovs: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let data = mem.data(store);
+    let iovs = crate::slice_from_raw_parts(iovs, niovs);
+    handle_result(check_iovecs(data.len(), iovs), |()| {
+        for iov in iovs {
+            let start = iov.offset as usize;
+            crate::slice_from_raw_parts_mut(iov.buf, iov.len)
+                .copy_from_slice(&data[start..start + iov.len]);
+        }
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_memory_writev(
+    store: CStoreContextMut<'_>,
+    mem: &Memory,
+    iovs: *const wasmtime_memory_iovec_t,
+    niovs: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let data = mem.data_mut(store);
+    let iovs = crate::slice_from_raw_parts(iovs, niovs);
+    handle_result(check_iovecs(data.len(), iovs), |()| {
+        for iov in iovs {
+            let start = iov.offset as usize;
+            data[start..start + iov.len]
+                .copy_from_slice(crate::slice_from_raw_parts(iov.buf, iov.len));
+        }
+    })
+}
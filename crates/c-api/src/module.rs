@@ -2,8 +2,9 @@ use crate::{
     handle_result, wasm_byte_vec_t, wasm_engine_t, wasm_exporttype_t, wasm_exporttype_vec_t,
     wasm_importtype_t, wasm_importtype_vec_t, wasm_store_t, wasmtime_error_t,
 };
-use anyhow::Context;
+use anyhow::{Context, Result};
 use std::ffi::CStr;
+use std::mem::MaybeUninit;
 use std::os::raw::c_char;
 use wasmtime::{Engine, Module};
 
@@ -33,7 +34,8 @@ pub unsafe extern "C" fn wasm_module_new(
     store: &mut wasm_store_t,
     binary: &wasm_byte_vec_t,
 ) -> Option<Box<wasm_module_t>> {
-    match Module::from_binary(store.store.context().engine(), binary.as_slice()) {
+    let engine = &store.engine;
+    match engine.compile(|| Module::from_binary(&engine.engine, binary.as_slice())) {
         Ok(module) => Some(Box::new(wasm_module_t::new(module))),
         Err(_) => None,
     }
@@ -44,7 +46,10 @@ pub unsafe extern "C" fn wasm_module_validate(
     store: &mut wasm_store_t,
     binary: &wasm_byte_vec_t,
 ) -> bool {
-    Module::validate(store.store.context().engine(), binary.as_slice()).is_ok()
+    let engine = &store.engine;
+    engine
+        .compile(|| Module::validate(&engine.engine, binary.as_slice()))
+        .is_ok()
 }
 
 fn fill_exports(module: &Module, out: &mut wasm_exporttype_vec_t) {
@@ -136,8 +141,9 @@ pub unsafe extern "C" fn wasmtime_module_new(
     len: usize,
     out: &mut *mut wasmtime_module_t,
 ) -> Option<Box<wasmtime_error_t>> {
+    let binary = crate::slice_from_raw_parts(wasm, len);
     handle_result(
-        Module::from_binary(&engine.engine, crate::slice_from_raw_parts(wasm, len)),
+        engine.compile(|| Module::from_binary(&engine.engine, binary)),
         |module| {
             *out = Box::into_raw(Box::new(wasmtime_module_t { module }));
         },
@@ -172,7 +178,10 @@ pub unsafe extern "C" fn wasmtime_module_validate(
     len: usize,
 ) -> Option<Box<wasmtime_error_t>> {
     let binary = crate::slice_from_raw_parts(wasm, len);
-    handle_result(Module::validate(&engine.engine, binary), |()| {})
+    handle_result(
+        engine.compile(|| Module::validate(&engine.engine, binary)),
+        |()| {},
+    )
 }
 
 #[no_mangle]
@@ -211,3 +220,87 @@ pub unsafe extern "C" fn wasmtime_module_deserialize_file(
         *out = Box::into_raw(Box::new(wasmtime_module_t { module }));
     })
 }
+
+#[no_mangle]
+pub extern "C" fn wasmtime_module_initialize_memory_image(
+    module: &wasmtime_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(module.module.initialize_copy_on_write_image(), |()| ())
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_module_uses_memory_image(
+    module: &wasmtime_module_t,
+    ret: &mut bool,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(module.module.uses_copy_on_write_image(), |uses| *ret = uses)
+}
+
+#[repr(C)]
+pub struct wasmtime_module_image_stats_t {
+    pub mapped: usize,
+    pub resident: usize,
+    pub shared: usize,
+    pub private_dirty: usize,
+    pub file_backed: bool,
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_module_image_stats(
+    module: &wasmtime_module_t,
+    stats: &mut MaybeUninit<wasmtime_module_image_stats_t>,
+) -> Option<Box<wasmtime_error_t>> {
+    let range = module.module.image_range();
+    let result = image_page_stats(range.clone()).map(|(resident, shared, private_dirty)| {
+        wasmtime_module_image_stats_t {
+            mapped: range.len(),
+            resident,
+            shared,
+            private_dirty,
+            file_backed: module.module.image_is_file_backed(),
+        }
+    });
+    handle_result(result, |s| crate::initialize(stats, s))
+}
+
+/// Sums the resident, shared and private dirty bytes of every mapping in
+/// `/proc/self/smaps` that overlaps `range`.
+#[cfg(target_os = "linux")]
+fn image_page_stats(range: std::ops::Range<usize>) -> Result<(usize, usize, usize)> {
+    let smaps = std::fs::read_to_string("/proc/self/smaps").context("failed to read smaps")?;
+    let (mut resident, mut shared, mut private_dirty) = (0, 0, 0);
+    let mut overlaps = false;
+    for line in smaps.lines() {
+        let mut parts = line.split_whitespace();
+        let key = parts.next().unwrap_or("");
+        if let Some((start, end)) = key.split_once('-') {
+            // A mapping header such as `7f12a000-7f12c000 r-xp ...`
+            if let (Ok(start), Ok(end)) = (
+                usize::from_str_radix(start, 16),
+                usize::from_str_radix(end, 16),
+            ) {
+                overlaps = start < range.end && range.start < end;
+                continue;
+            }
+        }
+        if !overlaps {
+            continue;
+        }
+        let kb = match parts.next().and_then(|n| n.parse::<usize>().ok()) {
+            Some(kb) => kb * 1024,
+            None => continue,
+        };
+        match key {
+            "Rss:" => resident += kb,
+            "Shared_Clean:" | "Shared_Dirty:" => shared += kb,
+            "Private_Dirty:" => private_dirty += kb,
+            _ => {}
+        }
+    }
+    Ok((resident, shared, private_dirty))
+}
+
+#[cfg(not(target_os = "linux"))]
+fn image_page_stats(_range: std::ops::Range<usize>) -> Result<(usize, usize, usize)> {
+    anyhow::bail!("module image statistics are only supported on Linux")
+}
@@ -1,8 +1,13 @@
 use crate::{wasm_engine_t, wasmtime_error_t, wasmtime_val_t, ForeignData};
 use std::cell::UnsafeCell;
 use std::ffi::c_void;
+use std::mem::{self, MaybeUninit};
 use std::sync::Arc;
-use wasmtime::{AsContext, AsContextMut, Store, StoreContext, StoreContextMut, Val};
+use std::time::Duration;
+use wasmtime::{
+    AsContext, AsContextMut, GcStats, ResourceLimiter, Store, StoreContext, StoreContextMut,
+    StoreLimits, StoreLimitsBuilder, StoreMemoryStats, Val,
+};
 
 /// This representation of a `Store` is used to implement the `wasm.h` API.
 ///
@@ -33,18 +38,21 @@ impl StoreRef {
 #[derive(Clone)]
 pub struct wasm_store_t {
     pub(crate) store: StoreRef,
+    /// The engine the store was created with, so `wasm_module_new` can
+    /// compile on its compilation pool.
+    pub(crate) engine: wasm_engine_t,
 }
 
 wasmtime_c_api_macros::declare_own!(wasm_store_t);
 
 #[no_mangle]
 pub extern "C" fn wasm_store_new(engine: &wasm_engine_t) -> Box<wasm_store_t> {
-    let engine = &engine.engine;
-    let store = Store::new(engine, ());
+    let store = Store::new(&engine.engine, ());
     Box::new(wasm_store_t {
         store: StoreRef {
             store: Arc::new(UnsafeCell::new(store)),
         },
+        engine: engine.clone(),
     })
 }
 
@@ -77,6 +85,137 @@ pub struct StoreData {
     /// Temporary storage for usage during host->wasm calls, same as above but
     /// for a different direction.
     pub wasm_val_storage: Vec<Val>,
+
+    /// Resource limiter installed on the store, used to observe growth.
+    pub(crate) limiter: StoreLimiter,
+}
+
+pub type wasmtime_memory_growth_callback_t = extern "C" fn(*mut c_void, usize, usize);
+pub type wasmtime_memory_growing_callback_t = extern "C" fn(*mut c_void, usize, usize) -> bool;
+pub type wasmtime_table_growing_callback_t = extern "C" fn(*mut c_void, u32, u32) -> bool;
+
+/// Limiter installed on every `wasmtime_store_t`.
+///
+/// By default it doesn't restrict anything beyond Wasmtime's defaults. It
+/// tracks when memories in the store are about to grow, so
+/// `wasmtime_memory_view_t` can tell whether it's stale, and how much memory
+/// and table space the store has been allowed to use. Static limits and
+/// growth callbacks can be configured with `wasmtime_store_limiter` and
+/// `wasmtime_store_limiter_callbacks`.
+#[derive(Default)]
+pub(crate) struct StoreLimiter {
+    /// Bumped every time a memory in the store is created or about to grow.
+    pub(crate) memory_generation: u64,
+    growth_callback: Option<(wasmtime_memory_growth_callback_t, ForeignData)>,
+    limits: StoreLimits,
+    callbacks: Option<LimiterCallbacks>,
+    pub(crate) usage: wasmtime_store_limiter_usage_t,
+    /// Growth allowed by the most recent `*_growing` call, taken back out of
+    /// `usage` if the grow then fails.
+    pending_memory_growth: usize,
+    pending_table_growth: u32,
+}
+
+struct LimiterCallbacks {
+    memory_growing: Option<wasmtime_memory_growing_callback_t>,
+    table_growing: Option<wasmtime_table_growing_callback_t>,
+    foreign: ForeignData,
+}
+
+impl StoreLimiter {
+    /// Accounts for an instance having been reset, which shrinks its
+    /// memories and tables back to their initial sizes without going through
+    /// the limiter.
+    ///
+    /// `usage` and `before` are taken right before the reset and `after`
+    /// right after it, so growth granted while the start function re-ran is
+    /// kept.
+    pub(crate) fn instance_reset(
+        &mut self,
+        usage: wasmtime_store_limiter_usage_t,
+        before: &StoreMemoryStats,
+        after: &StoreMemoryStats,
+    ) {
+        // Memories are rewritten even if they didn't change size, so views of
+        // them must be refreshed.
+        self.memory_generation += 1;
+        let memory_bytes =
+            |stats: &StoreMemoryStats| stats.memories.iter().map(|m| m.byte_size).sum::<usize>();
+        // `table_bytes` counts one pointer per element.
+        let table_elements =
+            |stats: &StoreMemoryStats| (stats.table_bytes / mem::size_of::<*mut u8>()) as u64;
+        self.usage.memory_bytes =
+            (usage.memory_bytes + memory_bytes(after)).saturating_sub(memory_bytes(before));
+        self.usage.table_elements =
+            (usage.table_elements + table_elements(after)).saturating_sub(table_elements(before));
+    }
+}
+
+#[repr(C)]
+#[derive(Clone, Default)]
+pub struct wasmtime_store_limiter_usage_t {
+    pub memory_bytes: usize,
+    pub table_elements: u64,
+}
+
+impl ResourceLimiter for StoreLimiter {
+    fn memory_growing(&mut self, current: usize, desired: usize, maximum: Option<usize>) -> bool {
+        self.memory_generation += 1;
+        if let Some((callback, foreign)) = &self.growth_callback {
+            callback(foreign.data, current, desired);
+        }
+        let allowed = self.limits.memory_growing(current, desired, maximum)
+            && match &self.callbacks {
+                Some(LimiterCallbacks {
+                    memory_growing: Some(callback),
+                    foreign,
+                    ..
+                }) => callback(foreign.data, current, desired),
+                _ => true,
+            };
+        if allowed {
+            self.pending_memory_growth = desired - current;
+            self.usage.memory_bytes += self.pending_memory_growth;
+        }
+        allowed
+    }
+
+    fn memory_grow_failed(&mut self, _error: &anyhow::Error) {
+        self.usage.memory_bytes -= mem::take(&mut self.pending_memory_growth);
+    }
+
+    fn table_growing(&mut self, current: u32, desired: u32, maximum: Option<u32>) -> bool {
+        let allowed = self.limits.table_growing(current, desired, maximum)
+            && match &self.callbacks {
+                Some(LimiterCallbacks {
+                    table_growing: Some(callback),
+                    foreign,
+                    ..
+                }) => callback(foreign.data, current, desired),
+                _ => true,
+            };
+        if allowed {
+            self.pending_table_growth = desired - current;
+            self.usage.table_elements += u64::from(self.pending_table_growth);
+        }
+        allowed
+    }
+
+    fn table_grow_failed(&mut self, _error: &anyhow::Error) {
+        self.usage.table_elements -= u64::from(mem::take(&mut self.pending_table_growth));
+    }
+
+    fn instances(&self) -> usize {
+        self.limits.instances()
+    }
+
+    fn tables(&self) -> usize {
+        self.limits.tables()
+    }
+
+    fn memories(&self) -> usize {
+        self.limits.memories()
+    }
 }
 
 #[no_mangle]
@@ -85,18 +224,145 @@ pub extern "C" fn wasmtime_store_new(
     data: *mut c_void,
     finalizer: Option<extern "C" fn(*mut c_void)>,
 ) -> Box<wasmtime_store_t> {
-    Box::new(wasmtime_store_t {
-        store: Store::new(
-            &engine.engine,
-            StoreData {
-                foreign: ForeignData { data, finalizer },
-                #[cfg(feature = "wasi")]
-                wasi: None,
-                hostcall_val_storage: Vec::new(),
-                wasm_val_storage: Vec::new(),
-            },
-        ),
-    })
+    let mut store = Store::new(
+        &engine.engine,
+        StoreData {
+            foreign: ForeignData { data, finalizer },
+            #[cfg(feature = "wasi")]
+            wasi: None,
+            hostcall_val_storage: Vec::new(),
+            wasm_val_storage: Vec::new(),
+            limiter: StoreLimiter::default(),
+        },
+    );
+    store.limiter(|data| &mut data.limiter);
+    Box::new(wasmtime_store_t { store })
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_store_memory_growth_callback(
+    store: &mut wasmtime_store_t,
+    callback: Option<wasmtime_memory_growth_callback_t>,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) {
+    let foreign = ForeignData { data, finalizer };
+    store.store.data_mut().limiter.growth_callback = callback.map(|cb| (cb, foreign));
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_store_limiter(
+    store: &mut wasmtime_store_t,
+    memory_size: i64,
+    table_elements: i64,
+    instances: i64,
+    tables: i64,
+    memories: i64,
+) {
+    let mut limiter = StoreLimitsBuilder::new();
+    if memory_size >= 0 {
+        limiter = limiter.memory_size(memory_size as usize);
+    }
+    if table_elements >= 0 {
+        limiter = limiter.table_elements(u32::try_from(table_elements).unwrap_or(u32::MAX));
+    }
+    if instances >= 0 {
+        limiter = limiter.instances(instances as usize);
+    }
+    if tables >= 0 {
+        limiter = limiter.tables(tables as usize);
+    }
+    if memories >= 0 {
+        limiter = limiter.memories(memories as usize);
+    }
+    store.store.data_mut().limiter.limits = limiter.build();
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_store_limiter_callbacks(
+    store: &mut wasmtime_store_t,
+    memory_growing: Option<wasmtime_memory_growing_callback_t>,
+    table_growing: Option<wasmtime_table_growing_callback_t>,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) {
+    let foreign = ForeignData { data, finalizer };
+    store.store.data_mut().limiter.callbacks =
+        if memory_growing.is_some() || table_growing.is_some() {
+            Some(LimiterCallbacks {
+                memory_growing,
+                table_growing,
+                foreign,
+            })
+        } else {
+            None
+        };
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_context_limiter_usage(
+    store: CStoreContext<'_>,
+    usage: &mut wasmtime_store_limiter_usage_t,
+) {
+    *usage = store.data().limiter.usage.clone();
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_context_memory_generation(store: CStoreContext<'_>) -> u64 {
+    store.data().limiter.memory_generation
+}
+
+#[repr(C)]
+pub struct wasmtime_memory_stats_t {
+    pub memories: usize,
+    pub memory_bytes: usize,
+    pub memory_resident_bytes: usize,
+    pub table_bytes: usize,
+    pub instance_bytes: usize,
+    pub code_bytes: usize,
+}
+
+#[repr(C)]
+pub struct wasmtime_linear_memory_stats_t {
+    pub byte_size: usize,
+    pub resident_bytes: usize,
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_context_memory_stats(
+    mut store: CStoreContextMut<'_>,
+    resident: bool,
+    stats: &mut MaybeUninit<wasmtime_memory_stats_t>,
+    memories: *mut MaybeUninit<wasmtime_linear_memory_stats_t>,
+    nmemories: usize,
+) {
+    let raw = store.memory_stats(resident);
+    let memories = crate::slice_from_raw_parts_mut(memories, nmemories);
+    let mut ret = wasmtime_memory_stats_t {
+        memories: raw.memories.len(),
+        memory_bytes: 0,
+        memory_resident_bytes: 0,
+        table_bytes: raw.table_bytes,
+        instance_bytes: raw.instance_bytes,
+        code_bytes: raw.code_bytes,
+    };
+    for (i, memory) in raw.memories.iter().enumerate() {
+        // Without residency information the whole memory is assumed to be
+        // resident, which is an upper bound.
+        let resident_bytes = memory.resident_bytes.unwrap_or(memory.byte_size);
+        ret.memory_bytes += memory.byte_size;
+        ret.memory_resident_bytes += resident_bytes;
+        if let Some(slot) = memories.get_mut(i) {
+            crate::initialize(
+                slot,
+                wasmtime_linear_memory_stats_t {
+                    byte_size: memory.byte_size,
+                    resident_bytes,
+                },
+            );
+        }
+    }
+    crate::initialize(stats, ret);
 }
 
 #[no_mangle]
@@ -125,11 +391,93 @@ pub extern "C" fn wasmtime_context_set_wasi(
     })
 }
 
+#[cfg(feature = "wasi")]
+#[no_mangle]
+pub extern "C" fn wasmtime_context_set_wasi_template(
+    mut context: CStoreContextMut<'_>,
+    template: &crate::wasi_template_t,
+    overrides: Option<Box<crate::wasi_config_t>>,
+) -> Option<Box<wasmtime_error_t>> {
+    let overrides = overrides.map(|c| *c).unwrap_or_default();
+    let wasi = overrides.into_wasi_ctx_with(Some(&template.template));
+    crate::handle_result(wasi, |wasi| {
+        context.data_mut().wasi = Some(wasi);
+    })
+}
+
 #[no_mangle]
 pub extern "C" fn wasmtime_context_gc(mut context: CStoreContextMut<'_>) {
     context.gc();
 }
 
+#[repr(C)]
+pub struct wasmtime_gc_stats_t {
+    pub collections: u64,
+    pub roots_scanned: u64,
+    pub refs_released: u64,
+    pub refs_freed: u64,
+    pub refs_pending: u64,
+    pub pause_nanos: u64,
+}
+
+impl From<GcStats> for wasmtime_gc_stats_t {
+    fn from(stats: GcStats) -> wasmtime_gc_stats_t {
+        wasmtime_gc_stats_t {
+            collections: stats.collections,
+            roots_scanned: stats.roots_scanned,
+            refs_released: stats.refs_released,
+            refs_freed: stats.refs_freed,
+            refs_pending: stats.refs_pending,
+            pause_nanos: u64::try_from(stats.pause.as_nanos()).unwrap_or(u64::MAX),
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_context_gc_step(
+    mut context: CStoreContextMut<'_>,
+    max_refs: usize,
+    max_time_nanos: u64,
+    stats: Option<&mut MaybeUninit<wasmtime_gc_stats_t>>,
+) {
+    let max_time = match max_time_nanos {
+        0 => None,
+        n => Some(Duration::from_nanos(n)),
+    };
+    let step = context.gc_step(max_refs, max_time);
+    if let Some(stats) = stats {
+        crate::initialize(stats, step.into());
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_context_set_gc_release_budget(
+    mut context: CStoreContextMut<'_>,
+    budget: usize,
+) {
+    let budget = match budget {
+        usize::MAX => None,
+        n => Some(n),
+    };
+    context.set_gc_release_budget(budget);
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_context_set_gc_trigger(
+    mut context: CStoreContextMut<'_>,
+    entries: usize,
+) {
+    context.set_gc_trigger(entries);
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_context_gc_stats(
+    context: CStoreContext<'_>,
+    stats: &mut MaybeUninit<wasmtime_gc_stats_t>,
+) {
+    crate::initialize(stats, context.gc_stats().into());
+}
+
 #[no_mangle]
 pub extern "C" fn wasmtime_context_add_fuel(
     mut store: CStoreContextMut<'_>,
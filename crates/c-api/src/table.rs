@@ -4,7 +4,7 @@ use crate::{
     wasmtime_val_t, CStoreContext, CStoreContextMut,
 };
 use std::mem::MaybeUninit;
-use wasmtime::{Extern, Table, TableType, Val, ValType};
+use wasmtime::{Extern, ExternRef, Table, TableType, Val, ValType};
 
 #[derive(Clone)]
 #[repr(transparent)]
@@ -179,3 +179,57 @@ pub unsafe extern "C" fn wasmtime_table_grow(
         *prev_size = prev
     })
 }
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_table_get_externrefs(
+    store: CStoreContextMut<'_>,
+    table: &Table,
+    index: u32,
+    out: *mut MaybeUninit<Option<ExternRef>>,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let out = crate::slice_from_raw_parts_mut(out, len);
+    for slot in out.iter_mut() {
+        crate::initialize(slot, None);
+    }
+    let out = std::slice::from_raw_parts_mut(out.as_mut_ptr().cast(), out.len());
+    handle_result(table.get_externrefs(store, index, out), |()| {})
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_table_set_externrefs(
+    store: CStoreContextMut<'_>,
+    table: &Table,
+    index: u32,
+    vals: *mut Option<ExternRef>,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let vals = crate::slice_from_raw_parts_mut(vals, len);
+    handle_result(table.set_externrefs(store, index, vals), |()| {})
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn wasmtime_table_fill(
+    store: CStoreContextMut<'_>,
+    table: &Table,
+    index: u32,
+    val: &wasmtime_val_t,
+    len: u32,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(table.fill(store, index, val.to_val(), len), |()| {})
+}
+
+#[no_mangle]
+pub extern "C" fn wasmtime_table_copy(
+    store: CStoreContextMut<'_>,
+    dst: &Table,
+    dst_index: u32,
+    src: &Table,
+    src_index: u32,
+    len: u32,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(
+        Table::copy(store, dst, dst_index, src, src_index, len),
+        |()| {},
+    )
+}
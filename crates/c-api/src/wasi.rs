@@ -1,15 +1,19 @@
 //! The WASI embedding API definitions for Wasmtime.
 
+use crate::wasm_byte_vec_t;
 use anyhow::Result;
 use cap_std::ambient_authority;
-use std::ffi::CStr;
+use std::ffi::{c_void, CStr};
 use std::fs::File;
+use std::io::{self, Write};
 use std::os::raw::{c_char, c_int};
 use std::path::{Path, PathBuf};
 use std::slice;
+use std::sync::{Arc, RwLock};
+use wasi_common::pipe::{ReadPipe, WritePipe};
 use wasmtime_wasi::{
     sync::{Dir, WasiCtxBuilder},
-    WasiCtx,
+    WasiCtx, WasiFile,
 };
 
 unsafe fn cstr_to_path<'a>(path: *const c_char) -> Option<&'a Path> {
@@ -29,21 +33,58 @@ unsafe fn create_file(path: *const c_char) -> Option<File> {
 pub struct wasi_config_t {
     args: Vec<Vec<u8>>,
     env: Vec<(Vec<u8>, Vec<u8>)>,
-    stdin: Option<File>,
-    stdout: Option<File>,
-    stderr: Option<File>,
+    stdin: WasiConfigReadPipe,
+    stdout: WasiConfigWritePipe,
+    stderr: WasiConfigWritePipe,
     preopens: Vec<(Dir, PathBuf)>,
     inherit_args: bool,
     inherit_env: bool,
-    inherit_stdin: bool,
-    inherit_stdout: bool,
-    inherit_stderr: bool,
+}
+
+enum WasiConfigReadPipe {
+    None,
+    Inherit,
+    File(File),
+    Bytes(Vec<u8>),
+}
+
+enum WasiConfigWritePipe {
+    None,
+    Inherit,
+    File(File),
+    Buffer(wasi_output_buffer_t),
+    Callback(CallbackWriter),
+}
+
+impl Default for WasiConfigReadPipe {
+    fn default() -> Self {
+        WasiConfigReadPipe::None
+    }
+}
+
+impl Default for WasiConfigWritePipe {
+    fn default() -> Self {
+        WasiConfigWritePipe::None
+    }
+}
+
+fn file_to_wasi(file: File) -> Box<dyn WasiFile> {
+    let file = cap_std::fs::File::from_std(file);
+    Box::new(wasi_cap_std_sync::file::File::from_cap_std(file))
 }
 
 wasmtime_c_api_macros::declare_own!(wasi_config_t);
 
 impl wasi_config_t {
     pub fn into_wasi_ctx(self) -> Result<WasiCtx> {
+        self.into_wasi_ctx_with(None)
+    }
+
+    /// Builds a `WasiCtx` from this configuration layered on top of
+    /// `template`. Arguments configured here replace the template's, while
+    /// environment variables and preopened directories are added to the
+    /// template's.
+    pub(crate) fn into_wasi_ctx_with(self, template: Option<&WasiTemplate>) -> Result<WasiCtx> {
         let mut builder = WasiCtxBuilder::new();
         if self.inherit_args {
             builder = builder.inherit_args()?;
@@ -54,6 +95,11 @@ impl wasi_config_t {
                 .map(|bytes| Ok(String::from_utf8(bytes)?))
                 .collect::<Result<Vec<String>>>()?;
             builder = builder.args(&args)?;
+        } else if let Some(template) = template {
+            builder = builder.args(&template.args)?;
+        }
+        if let Some(template) = template {
+            builder = builder.envs(&template.env)?;
         }
         if self.inherit_env {
             builder = builder.inherit_env()?;
@@ -69,26 +115,38 @@ impl wasi_config_t {
                 .collect::<Result<Vec<(String, String)>>>()?;
             builder = builder.envs(&env)?;
         }
-        if self.inherit_stdin {
-            builder = builder.inherit_stdin();
-        } else if let Some(file) = self.stdin {
-            let file = cap_std::fs::File::from_std(file);
-            let file = wasi_cap_std_sync::file::File::from_cap_std(file);
-            builder = builder.stdin(Box::new(file));
+        match self.stdin {
+            WasiConfigReadPipe::None => {}
+            WasiConfigReadPipe::Inherit => builder = builder.inherit_stdin(),
+            WasiConfigReadPipe::File(file) => builder = builder.stdin(file_to_wasi(file)),
+            WasiConfigReadPipe::Bytes(bytes) => {
+                builder = builder.stdin(Box::new(ReadPipe::from(bytes)));
+            }
         }
-        if self.inherit_stdout {
-            builder = builder.inherit_stdout();
-        } else if let Some(file) = self.stdout {
-            let file = cap_std::fs::File::from_std(file);
-            let file = wasi_cap_std_sync::file::File::from_cap_std(file);
-            builder = builder.stdout(Box::new(file));
+        match self.stdout {
+            WasiConfigWritePipe::None => {}
+            WasiConfigWritePipe::Inherit => builder = builder.inherit_stdout(),
+            WasiConfigWritePipe::File(file) => builder = builder.stdout(file_to_wasi(file)),
+            WasiConfigWritePipe::Buffer(buffer) => builder = builder.stdout(buffer.to_wasi()),
+            WasiConfigWritePipe::Callback(writer) => {
+                builder = builder.stdout(Box::new(WritePipe::new(writer)));
+            }
         }
-        if self.inherit_stderr {
-            builder = builder.inherit_stderr();
-        } else if let Some(file) = self.stderr {
-            let file = cap_std::fs::File::from_std(file);
-            let file = wasi_cap_std_sync::file::File::from_cap_std(file);
-            builder = builder.stderr(Box::new(file));
+        match self.stderr {
+            WasiConfigWritePipe::None => {}
+            WasiConfigWritePipe::Inherit => builder = builder.inherit_stderr(),
+            WasiConfigWritePipe::File(file) => builder = builder.stderr(file_to_wasi(file)),
+            WasiConfigWritePipe::Buffer(buffer) => builder = builder.stderr(buffer.to_wasi()),
+            WasiConfigWritePipe::Callback(writer) => {
+                builder = builder.stderr(Box::new(WritePipe::new(writer)));
+            }
+        }
+        if let Some(template) = template {
+            // Duplicate the template's handles rather than re-opening the
+            // directories by path.
+            for (dir, path) in &template.preopens {
+                builder = builder.preopened_dir(dir.try_clone()?, path)?;
+            }
         }
         for (dir, path) in self.preopens {
             builder = builder.preopened_dir(dir, path)?;
@@ -97,6 +155,63 @@ impl wasi_config_t {
     }
 }
 
+/// Arguments, environment and preopened directories which are prepared once
+/// and shared by every store configured from a `wasi_template_t`.
+pub(crate) struct WasiTemplate {
+    args: Vec<String>,
+    env: Vec<(String, String)>,
+    preopens: Vec<(Dir, PathBuf)>,
+}
+
+#[derive(Clone)]
+pub struct wasi_template_t {
+    pub(crate) template: Arc<WasiTemplate>,
+}
+
+wasmtime_c_api_macros::declare_own!(wasi_template_t);
+
+#[no_mangle]
+pub extern "C" fn wasi_template_new(config: Box<wasi_config_t>) -> Option<Box<wasi_template_t>> {
+    let config = *config;
+    // `args`/`vars` would panic on a non-UTF-8 value, and panicking isn't an
+    // option across the C boundary.
+    let args = if config.inherit_args {
+        std::env::args_os()
+            .map(|arg| arg.into_string().ok())
+            .collect::<Option<_>>()?
+    } else {
+        config
+            .args
+            .into_iter()
+            .map(String::from_utf8)
+            .collect::<Result<_, _>>()
+            .ok()?
+    };
+    let env = if config.inherit_env {
+        std::env::vars_os()
+            .map(|(k, v)| Some((k.into_string().ok()?, v.into_string().ok()?)))
+            .collect::<Option<_>>()?
+    } else {
+        config
+            .env
+            .into_iter()
+            .map(|(k, v)| Some((String::from_utf8(k).ok()?, String::from_utf8(v).ok()?)))
+            .collect::<Option<_>>()?
+    };
+    Some(Box::new(wasi_template_t {
+        template: Arc::new(WasiTemplate {
+            args,
+            env,
+            preopens: config.preopens,
+        }),
+    }))
+}
+
+#[no_mangle]
+pub extern "C" fn wasi_template_clone(template: &wasi_template_t) -> Box<wasi_template_t> {
+    Box::new(template.clone())
+}
+
 #[no_mangle]
 pub extern "C" fn wasi_config_new() -> Box<wasi_config_t> {
     Box::new(wasi_config_t::default())
@@ -159,16 +274,14 @@ pub unsafe extern "C" fn wasi_config_set_stdin_file(
         None => return false,
     };
 
-    config.stdin = Some(file);
-    config.inherit_stdin = false;
+    config.stdin = WasiConfigReadPipe::File(file);
 
     true
 }
 
 #[no_mangle]
 pub extern "C" fn wasi_config_inherit_stdin(config: &mut wasi_config_t) {
-    config.stdin = None;
-    config.inherit_stdin = true;
+    config.stdin = WasiConfigReadPipe::Inherit;
 }
 
 #[no_mangle]
@@ -181,16 +294,14 @@ pub unsafe extern "C" fn wasi_config_set_stdout_file(
         None => return false,
     };
 
-    config.stdout = Some(file);
-    config.inherit_stdout = false;
+    config.stdout = WasiConfigWritePipe::File(file);
 
     true
 }
 
 #[no_mangle]
 pub extern "C" fn wasi_config_inherit_stdout(config: &mut wasi_config_t) {
-    config.stdout = None;
-    config.inherit_stdout = true;
+    config.stdout = WasiConfigWritePipe::Inherit;
 }
 
 #[no_mangle]
@@ -203,16 +314,113 @@ pub unsafe extern "C" fn wasi_config_set_stderr_file(
         None => return false,
     };
 
-    (*config).stderr = Some(file);
-    (*config).inherit_stderr = false;
+    (*config).stderr = WasiConfigWritePipe::File(file);
 
     true
 }
 
 #[no_mangle]
 pub extern "C" fn wasi_config_inherit_stderr(config: &mut wasi_config_t) {
-    config.stderr = None;
-    config.inherit_stderr = true;
+    config.stderr = WasiConfigWritePipe::Inherit;
+}
+
+#[no_mangle]
+pub extern "C" fn wasi_config_set_stdin_bytes(
+    config: &mut wasi_config_t,
+    binary: &mut wasm_byte_vec_t,
+) {
+    config.stdin = WasiConfigReadPipe::Bytes(binary.take());
+}
+
+/// A growable in-memory buffer that captures a WASI output stream, shared
+/// between the C host and the `WasiCtx` writing to it.
+#[derive(Clone, Default)]
+pub struct wasi_output_buffer_t {
+    buf: Arc<RwLock<Vec<u8>>>,
+}
+
+wasmtime_c_api_macros::declare_own!(wasi_output_buffer_t);
+
+impl wasi_output_buffer_t {
+    fn to_wasi(&self) -> Box<dyn WasiFile> {
+        Box::new(WritePipe::from_shared(self.buf.clone()))
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn wasi_output_buffer_new() -> Box<wasi_output_buffer_t> {
+    Box::new(wasi_output_buffer_t::default())
+}
+
+#[no_mangle]
+pub extern "C" fn wasi_output_buffer_take(
+    buffer: &wasi_output_buffer_t,
+    out: &mut wasm_byte_vec_t,
+) {
+    let contents = std::mem::take(&mut *buffer.buf.write().unwrap());
+    out.set_buffer(contents);
+}
+
+#[no_mangle]
+pub extern "C" fn wasi_config_set_stdout_buffer(
+    config: &mut wasi_config_t,
+    buffer: &wasi_output_buffer_t,
+) {
+    config.stdout = WasiConfigWritePipe::Buffer(buffer.clone());
+}
+
+#[no_mangle]
+pub extern "C" fn wasi_config_set_stderr_buffer(
+    config: &mut wasi_config_t,
+    buffer: &wasi_output_buffer_t,
+) {
+    config.stderr = WasiConfigWritePipe::Buffer(buffer.clone());
+}
+
+pub type wasi_output_callback_t = extern "C" fn(*mut c_void, *const u8, usize) -> isize;
+
+/// Forwards writes to a WASI output stream to a C callback.
+struct CallbackWriter {
+    callback: wasi_output_callback_t,
+    foreign: crate::ForeignData,
+}
+
+impl Write for CallbackWriter {
+    fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
+        match (self.callback)(self.foreign.data, buf.as_ptr(), buf.len()) {
+            n if n >= 0 => Ok(n as usize),
+            _ => Err(io::Error::new(
+                io::ErrorKind::Other,
+                "output callback failed",
+            )),
+        }
+    }
+
+    fn flush(&mut self) -> io::Result<()> {
+        Ok(())
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn wasi_config_set_stdout_callback(
+    config: &mut wasi_config_t,
+    callback: wasi_output_callback_t,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) {
+    let foreign = crate::ForeignData { data, finalizer };
+    config.stdout = WasiConfigWritePipe::Callback(CallbackWriter { callback, foreign });
+}
+
+#[no_mangle]
+pub extern "C" fn wasi_config_set_stderr_callback(
+    config: &mut wasi_config_t,
+    callback: wasi_output_callback_t,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) {
+    let foreign = crate::ForeignData { data, finalizer };
+    config.stderr = WasiConfigWritePipe::Callback(CallbackWriter { callback, foreign });
 }
 
 #[no_mangle]
@@ -466,6 +466,25 @@ impl MemoryImageSlot {
         Ok(())
     }
 
+    /// Discards everything written to this slot since it was instantiated
+    /// and instantiates it again with the same image and `initial_size_bytes`
+    /// accessible.
+    pub(crate) fn reset(&mut self, initial_size_bytes: usize) -> Result<()> {
+        // Keep the image around since `clear_and_remain_ready` drops it on
+        // platforms which can't restore it in place.
+        let image = self.image.clone();
+        self.clear_and_remain_ready()?;
+        // Off Linux the clear above remapped the whole slot as inaccessible,
+        // so make the initial heap usable again before the image goes back.
+        #[cfg(not(target_os = "linux"))]
+        self.set_protection(
+            0..self.initial_size,
+            rustix::mm::MprotectFlags::READ | rustix::mm::MprotectFlags::WRITE,
+        )?;
+        self.instantiate(initial_size_bytes, image.as_ref())?;
+        Ok(())
+    }
+
     #[allow(dead_code)] // ignore warnings as this is only used in some cfgs
     pub(crate) fn clear_and_remain_ready(&mut self) -> Result<()> {
         assert!(self.dirty);
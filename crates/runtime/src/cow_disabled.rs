@@ -61,6 +61,10 @@ impl MemoryImageSlot {
         unreachable!();
     }
 
+    pub(crate) fn reset(&mut self, _: usize) -> Result<()> {
+        unreachable!();
+    }
+
     pub(crate) fn has_image(&self) -> bool {
         unreachable!();
     }
@@ -109,6 +109,7 @@ use std::mem;
 use std::ops::Deref;
 use std::ptr::{self, NonNull};
 use std::sync::atomic::{self, AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
 use wasmtime_environ::StackMap;
 
 use crate::Backtrace;
@@ -411,6 +412,50 @@ impl VMExternRef {
         x
     }
 
+    /// Add `n` references to the raw `VMExternRef` pointer `ptr` with a single
+    /// atomic operation.
+    ///
+    /// This is equivalent to calling `clone_from_raw` `n` times and passing
+    /// each result to `into_raw`, but avoids one atomic operation per clone
+    /// when the same reference is stored many times.
+    ///
+    /// # Safety
+    ///
+    /// Same as `clone_from_raw`.
+    pub unsafe fn clone_raw_n(ptr: *mut u8, n: usize) {
+        debug_assert!(!ptr.is_null());
+        if n > 0 {
+            let data = &*ptr.cast::<VMExternData>();
+            data.ref_count.fetch_add(n, Ordering::Relaxed);
+        }
+    }
+
+    /// Release `n` references to the raw `VMExternRef` pointer `ptr` with a
+    /// single atomic operation, freeing the data if these were the last ones.
+    ///
+    /// This is equivalent to calling `from_raw` `n` times and dropping each
+    /// result.
+    ///
+    /// # Safety
+    ///
+    /// `ptr` must be the result of a previous `as_raw` or `into_raw` call and
+    /// the caller must own at least `n` references to it, none of which may be
+    /// used after this call.
+    pub unsafe fn drop_raw_n(ptr: *mut u8, n: usize) {
+        debug_assert!(!ptr.is_null());
+        if n == 0 {
+            return;
+        }
+        let data = NonNull::new_unchecked(ptr).cast::<VMExternData>();
+
+        // See `Drop for VMExternRef` for the memory orderings used here.
+        if data.as_ref().ref_count.fetch_sub(n, Ordering::Release) != n {
+            return;
+        }
+        atomic::fence(Ordering::Acquire);
+        VMExternData::drop_and_dealloc(data);
+    }
+
     /// Get the strong reference count for this `VMExternRef`.
     ///
     /// Note that this loads with a `SeqCst` ordering to synchronize with other
@@ -531,6 +576,24 @@ pub struct VMExternRefActivationsTable {
     /// than create a new hash set every GC.
     precise_stack_roots: HashSet<VMExternRefWithTraits>,
 
+    /// References which a GC found to be no longer used by Wasm but which
+    /// haven't been dropped yet because the collection ran out of budget.
+    ///
+    /// This isn't bounded, so it grows for as long as references are swept
+    /// faster than the release budget drops them.
+    pending_release: Vec<VMExternRef>,
+
+    /// The maximum number of references a GC drops, or `None` to drop all of
+    /// them.
+    release_budget: Option<usize>,
+
+    /// The number of slots in the bump chunk, which is how many fast-path
+    /// insertions can happen before a GC is triggered.
+    chunk_size: usize,
+
+    /// Totals for every GC performed with this table.
+    stats: GcStats,
+
     /// A debug-only field for asserting that we are in a region of code where
     /// GC is okay to preform.
     #[cfg(debug_assertions)]
@@ -591,6 +654,10 @@ impl VMExternRefActivationsTable {
             },
             over_approximated_stack_roots: HashSet::new(),
             precise_stack_roots: HashSet::new(),
+            pending_release: Vec::new(),
+            release_budget: None,
+            chunk_size: Self::CHUNK_SIZE,
+            stats: GcStats::default(),
             #[cfg(debug_assertions)]
             gc_okay: true,
         }
@@ -731,8 +798,8 @@ impl VMExternRefActivationsTable {
             *self.alloc.next.get() = self.alloc.end;
         }
         for slot in self.alloc.chunk.iter().take(num_filled) {
-            unsafe {
-                *slot.get() = None;
+            if let Some(r) = unsafe { (*slot.get()).take() } {
+                self.pending_release.push(r);
             }
         }
         debug_assert!(
@@ -745,8 +812,9 @@ impl VMExternRefActivationsTable {
 
         // If this is the first instance of gc then the initial chunk is empty,
         // so we lazily allocate space for fast bump-allocation in the future.
-        if self.alloc.chunk.is_empty() {
-            self.alloc.chunk = Self::new_chunk(Self::CHUNK_SIZE);
+        // The chunk is also replaced if the GC trigger was changed.
+        if self.alloc.chunk.len() != self.chunk_size {
+            self.alloc.chunk = Self::new_chunk(self.chunk_size);
             self.alloc.end =
                 NonNull::new(unsafe { self.alloc.chunk.as_mut_ptr().add(self.alloc.chunk.len()) })
                     .unwrap();
@@ -766,17 +834,75 @@ impl VMExternRefActivationsTable {
             &mut self.over_approximated_stack_roots,
         );
 
-        // And finally, the new `precise_stack_roots` should be cleared and
-        // remain empty until the next GC cycle.
-        //
-        // Note that this may run arbitrary code as we run externref
-        // destructors. Because of our `&mut` borrow above on this table,
-        // though, we're guaranteed that nothing will touch this table.
-        self.precise_stack_roots.clear();
+        // And finally, the new `precise_stack_roots` should be emptied and
+        // remain empty until the next GC cycle. Its references, along with
+        // the bump chunk's, are dropped by `release_pending` afterwards.
+        self.pending_release
+            .extend(self.precise_stack_roots.drain().map(|r| r.0));
 
         log::trace!("end GC sweep");
     }
 
+    /// Drop up to `max_refs` of the references queued by previous sweeps,
+    /// stopping early once `deadline` has passed.
+    ///
+    /// Note that this may run arbitrary code as we run externref destructors.
+    /// Because of our `&mut` borrow on this table, though, we're guaranteed
+    /// that nothing will touch this table.
+    fn release_pending(&mut self, max_refs: usize, deadline: Option<Instant>, stats: &mut GcStats) {
+        let mut released = 0;
+        while released < max_refs {
+            // Only look at the clock every so often since dropping a
+            // reference is usually much cheaper than reading it.
+            if released % 64 == 0 && deadline.map_or(false, |d| Instant::now() >= d) {
+                break;
+            }
+            let r = match self.pending_release.pop() {
+                Some(r) => r,
+                None => break,
+            };
+            if r.strong_count() == 1 {
+                stats.refs_freed += 1;
+            }
+            drop(r);
+            released += 1;
+        }
+        stats.refs_released += released as u64;
+    }
+
+    /// Limit how many references each GC drops.
+    ///
+    /// With `Some(n)` a GC still finds the precise set of stack roots, but
+    /// only drops up to `n` of the references it found to be unused, keeping
+    /// the rest for later collections. This bounds the time spent running
+    /// externref destructors in any one GC, but not the number of references
+    /// left waiting, which keeps growing if `n` stays below the rate at which
+    /// references are inserted. With `None`, the default, every unused
+    /// reference is dropped.
+    pub fn set_release_budget(&mut self, budget: Option<usize>) {
+        self.release_budget = budget;
+    }
+
+    /// Set how many references may be inserted on the fast path before a GC
+    /// is automatically triggered.
+    ///
+    /// Values smaller than the default of 512 are rounded up to it. The new
+    /// size takes effect at the next GC.
+    pub fn set_gc_trigger(&mut self, entries: usize) {
+        self.chunk_size = cmp::max(entries, Self::CHUNK_SIZE);
+    }
+
+    /// Get the totals for every GC performed with this table so far.
+    ///
+    /// `refs_pending` is the number of references currently waiting to be
+    /// dropped.
+    pub fn gc_stats(&self) -> GcStats {
+        GcStats {
+            refs_pending: self.pending_release.len() as u64,
+            ..self.stats
+        }
+    }
+
     /// Set whether it is okay to GC or not right now.
     ///
     /// This is provided as a helper for enabling various debug-only assertions
@@ -842,8 +968,53 @@ impl<T> std::ops::DerefMut for DebugOnly<T> {
     }
 }
 
+/// Statistics about `VMExternRef` garbage collections.
+#[derive(Clone, Copy, Debug, Default)]
+pub struct GcStats {
+    /// The number of collections performed.
+    pub collections: u64,
+    /// The number of `externref` roots found in Wasm frames on the stack.
+    pub roots_scanned: u64,
+    /// The number of references dropped from the activations table.
+    pub refs_released: u64,
+    /// How many of the released references were the last reference to their
+    /// data, which was then freed.
+    pub refs_freed: u64,
+    /// The number of references waiting to be dropped by a later collection.
+    pub refs_pending: u64,
+    /// The time spent collecting.
+    pub pause: Duration,
+}
+
 /// Perform garbage collection of `VMExternRef`s.
 ///
+/// This drops as many unused references as the table's release budget
+/// allows, see `VMExternRefActivationsTable::set_release_budget`.
+///
+/// # Unsafety
+///
+/// Same as `gc_with_budget`.
+pub unsafe fn gc(
+    module_info_lookup: &dyn ModuleInfoLookup,
+    externref_activations_table: &mut VMExternRefActivationsTable,
+) {
+    let max_refs = externref_activations_table.release_budget;
+    gc_with_budget(
+        module_info_lookup,
+        externref_activations_table,
+        max_refs,
+        None,
+    );
+}
+
+/// Perform garbage collection of `VMExternRef`s, dropping at most `max_refs`
+/// unused references (all of them if `None`) and stopping once `deadline` has
+/// passed.
+///
+/// Finding the stack roots isn't incremental, but dropping the references
+/// they replace is, so references which aren't dropped are kept until a later
+/// collection. Returns statistics for this collection alone.
+///
 /// # Unsafety
 ///
 /// You must have called `VMExternRefActivationsTable::set_stack_canary` for at
@@ -853,11 +1024,18 @@ impl<T> std::ops::DerefMut for DebugOnly<T> {
 ///
 /// Additionally, you must have registered the stack maps for every Wasm module
 /// that has frames on the stack with the given `stack_maps_registry`.
-pub unsafe fn gc(
+pub unsafe fn gc_with_budget(
     module_info_lookup: &dyn ModuleInfoLookup,
     externref_activations_table: &mut VMExternRefActivationsTable,
-) {
+    max_refs: Option<usize>,
+    deadline: Option<Instant>,
+) -> GcStats {
     log::debug!("start GC");
+    let start = Instant::now();
+    let mut stats = GcStats {
+        collections: 1,
+        ..GcStats::default()
+    };
 
     #[cfg(debug_assertions)]
     assert!(externref_activations_table.gc_okay);
@@ -950,6 +1128,7 @@ pub unsafe fn gc(
             );
 
             if let Some(r) = NonNull::new(r) {
+                stats.roots_scanned += 1;
                 VMExternRefActivationsTable::insert_precise_stack_root(
                     &mut externref_activations_table.precise_stack_roots,
                     r,
@@ -962,8 +1141,23 @@ pub unsafe fn gc(
     log::trace!("end GC trace");
 
     externref_activations_table.sweep();
+    externref_activations_table.release_pending(
+        max_refs.unwrap_or(usize::MAX),
+        deadline,
+        &mut stats,
+    );
+
+    stats.pause = start.elapsed();
+    stats.refs_pending = externref_activations_table.pending_release.len() as u64;
+    let total = &mut externref_activations_table.stats;
+    total.collections += stats.collections;
+    total.roots_scanned += stats.roots_scanned;
+    total.refs_released += stats.refs_released;
+    total.refs_freed += stats.refs_freed;
+    total.pause += stats.pause;
 
     log::debug!("end GC");
+    stats
 }
 
 #[cfg(test)]
@@ -985,6 +1179,20 @@ mod tests {
         );
     }
 
+    #[test]
+    fn clone_and_drop_raw_n() {
+        let r = VMExternRef::new(String::from("hi"));
+        let raw = r.as_raw();
+        unsafe {
+            VMExternRef::clone_raw_n(raw, 3);
+            assert_eq!(r.strong_count(), 4);
+            VMExternRef::drop_raw_n(raw, 2);
+            assert_eq!(r.strong_count(), 2);
+            VMExternRef::drop_raw_n(raw, 1);
+        }
+        assert_eq!(r.strong_count(), 1);
+    }
+
     #[test]
     fn ref_count_is_at_correct_offset() {
         let s = "hi";
@@ -1073,4 +1281,35 @@ mod tests {
             actual_offset
         );
     }
+
+    /// Module lookup for collections with no Wasm frames on the stack.
+    struct NoWasm;
+
+    impl ModuleInfoLookup for NoWasm {
+        fn lookup(&self, _pc: usize) -> Option<&dyn ModuleInfo> {
+            None
+        }
+    }
+
+    #[test]
+    fn set_gc_trigger_resizes_bump_chunk_at_next_gc() {
+        let chunk_size = VMExternRefActivationsTable::CHUNK_SIZE;
+        let mut table = VMExternRefActivationsTable::new();
+        assert_eq!(table.bump_capacity_remaining(), 0);
+
+        table.set_gc_trigger(2 * chunk_size);
+        assert_eq!(table.bump_capacity_remaining(), 0);
+        unsafe { gc(&NoWasm, &mut table) };
+        assert_eq!(table.bump_capacity_remaining(), 2 * chunk_size);
+
+        // Smaller triggers are rounded up to the default chunk size, and the
+        // current chunk keeps being used until the next GC.
+        table.set_gc_trigger(1);
+        for i in 0..3 {
+            table.insert_without_gc(VMExternRef::new(i));
+        }
+        assert_eq!(table.bump_capacity_remaining(), 2 * chunk_size - 3);
+        unsafe { gc(&NoWasm, &mut table) };
+        assert_eq!(table.bump_capacity_remaining(), chunk_size);
+    }
 }
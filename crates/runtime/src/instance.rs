@@ -30,7 +30,7 @@ use wasmtime_environ::{
     packed_option::ReservedValue, DataIndex, DefinedGlobalIndex, DefinedMemoryIndex,
     DefinedTableIndex, ElemIndex, EntityIndex, EntityRef, EntitySet, FuncIndex, GlobalIndex,
     GlobalInit, HostPtr, MemoryIndex, Module, PrimaryMap, SignatureIndex, TableIndex,
-    TableInitialization, TrapCode, VMOffsets, WasmType,
+    TableInitialization, TrapCode, VMOffsets, WasmType, WASM_PAGE_SIZE,
 };
 
 mod allocator;
@@ -969,6 +969,63 @@ impl Instance {
         self.initialize_vmctx_globals(module);
     }
 
+    /// Puts this instance's memories, tables and globals back into the state
+    /// they were in when the instance was first allocated and initialized.
+    ///
+    /// Imported items are left alone, including active segments that target
+    /// imported tables and memories, and this doesn't run the start function.
+    fn reset(&mut self, is_bulk_memory: bool) -> Result<(), InstantiationError> {
+        let module = self.module().clone();
+
+        for index in self.memories.keys() {
+            let minimum = module.memory_plans[module.memory_index(index)]
+                .memory
+                .minimum;
+            let initial_size = minimum
+                .checked_mul(u64::from(WASM_PAGE_SIZE))
+                .and_then(|size| usize::try_from(size).ok())
+                .unwrap();
+            let memory = &mut self.memories[index];
+            memory
+                .reset(initial_size)
+                .map_err(InstantiationError::Resource)?;
+            if memory.as_shared_memory().is_none() {
+                let vmmemory = memory.vmmemory();
+                self.set_memory(index, vmmemory);
+            }
+        }
+
+        for index in self.tables.keys() {
+            let minimum = module.table_plans[module.table_index(index)].table.minimum;
+            let table = &mut self.tables[index];
+            table.reset(minimum);
+            let vmtable = table.vmtable();
+            self.set_table(index, vmtable);
+        }
+
+        // Globals holding an `externref` own a reference which needs to be
+        // released before they're overwritten with their initial values.
+        for (index, global) in module.globals.iter() {
+            let index = match module.defined_global_index(index) {
+                Some(index) => index,
+                None => continue,
+            };
+            if let WasmType::ExternRef = global.wasm_ty {
+                unsafe {
+                    drop((*self.global_ptr(index)).as_externref_mut().take());
+                }
+            }
+        }
+        unsafe {
+            self.initialize_vmctx_globals(&module);
+        }
+
+        self.dropped_elements.clear();
+        self.dropped_data.clear();
+
+        allocator::initialize_instance(self, &module, is_bulk_memory, false)
+    }
+
     unsafe fn initialize_vmctx_globals(&mut self, module: &Module) {
         let num_imports = module.num_imported_globals;
         for (index, global) in module.globals.iter().skip(num_imports) {
@@ -1132,6 +1189,37 @@ impl InstanceHandle {
         self.instance_mut().get_defined_memory(index)
     }
 
+    /// Resets this instance back to the state it was in right after it was
+    /// instantiated, before its start function ran.
+    ///
+    /// Defined memories get their initial size and contents back, using
+    /// copy-on-write images where available, defined tables and globals are
+    /// re-initialized, and dropped data and element segments are restored.
+    ///
+    /// # Safety
+    ///
+    /// No WebAssembly code of this instance may be executing, and the caller
+    /// must not hold on to pointers into its memories, tables or globals.
+    pub unsafe fn reset(&mut self, is_bulk_memory: bool) -> Result<(), InstantiationError> {
+        self.instance_mut().reset(is_bulk_memory)
+    }
+
+    /// Return the linear memories defined within this instance.
+    pub fn defined_memories_mut(&mut self) -> impl Iterator<Item = &mut Memory> + '_ {
+        self.instance_mut().memories.values_mut()
+    }
+
+    /// Return the tables defined within this instance.
+    pub fn defined_tables(&self) -> impl Iterator<Item = &Table> + '_ {
+        self.instance().tables.values()
+    }
+
+    /// Returns the number of bytes of host memory allocated for this
+    /// instance's runtime state, including its `VMContext`.
+    pub fn allocation_size(&self) -> usize {
+        Instance::alloc_layout(&self.instance().offsets).size()
+    }
+
     /// Return the table index for the given `VMTableDefinition` in this instance.
     pub unsafe fn table_index(&self, table: &VMTableDefinition) -> DefinedTableIndex {
         self.instance().table_index(table)
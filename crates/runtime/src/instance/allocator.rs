@@ -216,11 +216,15 @@ fn get_table_init_start(
 fn check_table_init_bounds(
     instance: &mut Instance,
     module: &Module,
+    init_imports: bool,
 ) -> Result<(), InstantiationError> {
     match &module.table_initialization {
         TableInitialization::FuncTable { segments, .. }
         | TableInitialization::Segments { segments } => {
             for segment in segments {
+                if !init_imports && module.defined_table_index(segment.table_index).is_none() {
+                    continue;
+                }
                 let table = unsafe { &*instance.get_table(segment.table_index) };
                 let start = get_table_init_start(segment, instance)?;
                 let start = usize::try_from(start).unwrap();
@@ -243,7 +247,11 @@ fn check_table_init_bounds(
     Ok(())
 }
 
-fn initialize_tables(instance: &mut Instance, module: &Module) -> Result<(), InstantiationError> {
+fn initialize_tables(
+    instance: &mut Instance,
+    module: &Module,
+    init_imports: bool,
+) -> Result<(), InstantiationError> {
     // Note: if the module's table initializer state is in
     // FuncTable mode, we will lazily initialize tables based on
     // any statically-precomputed image of FuncIndexes, but there
@@ -255,6 +263,9 @@ fn initialize_tables(instance: &mut Instance, module: &Module) -> Result<(), Ins
         TableInitialization::FuncTable { segments, .. }
         | TableInitialization::Segments { segments } => {
             for segment in segments {
+                if !init_imports && module.defined_table_index(segment.table_index).is_none() {
+                    continue;
+                }
                 instance
                     .table_init_segment(
                         segment.table_index,
@@ -304,8 +315,13 @@ fn get_memory_init_start(
 fn check_memory_init_bounds(
     instance: &Instance,
     initializers: &[MemoryInitializer],
+    init_imports: bool,
 ) -> Result<(), InstantiationError> {
+    let module = instance.module();
     for init in initializers {
+        if !init_imports && module.defined_memory_index(init.memory_index).is_none() {
+            continue;
+        }
         let memory = instance.get_memory(init.memory_index);
         let start = get_memory_init_start(init, instance)?;
         let end = usize::try_from(start)
@@ -327,7 +343,11 @@ fn check_memory_init_bounds(
     Ok(())
 }
 
-fn initialize_memories(instance: &mut Instance, module: &Module) -> Result<(), InstantiationError> {
+fn initialize_memories(
+    instance: &mut Instance,
+    module: &Module,
+    init_imports: bool,
+) -> Result<(), InstantiationError> {
     let memory_size_in_pages =
         &|memory| (instance.get_memory(memory).current_length() as u64) / u64::from(WASM_PAGE_SIZE);
 
@@ -364,10 +384,14 @@ fn initialize_memories(instance: &mut Instance, module: &Module) -> Result<(), I
             // doesn't need initialization, due to something like copy-on-write
             // pre-initializing it via mmap magic, then this initializer can be
             // skipped entirely.
-            if let Some(memory_index) = module.defined_memory_index(memory_index) {
-                if !instance.memories[memory_index].needs_init() {
-                    return true;
+            match module.defined_memory_index(memory_index) {
+                Some(memory_index) => {
+                    if !instance.memories[memory_index].needs_init() {
+                        return true;
+                    }
                 }
+                None if !init_imports => return true,
+                None => {}
             }
             let memory = instance.get_memory(memory_index);
 
@@ -389,12 +413,16 @@ fn initialize_memories(instance: &mut Instance, module: &Module) -> Result<(), I
     Ok(())
 }
 
-fn check_init_bounds(instance: &mut Instance, module: &Module) -> Result<(), InstantiationError> {
-    check_table_init_bounds(instance, module)?;
+fn check_init_bounds(
+    instance: &mut Instance,
+    module: &Module,
+    init_imports: bool,
+) -> Result<(), InstantiationError> {
+    check_table_init_bounds(instance, module, init_imports)?;
 
     match &instance.module().memory_initialization {
         MemoryInitialization::Segmented(initializers) => {
-            check_memory_init_bounds(instance, initializers)?;
+            check_memory_init_bounds(instance, initializers, init_imports)?;
         }
         // Statically validated already to have everything in-bounds.
         MemoryInitialization::Static { .. } => {}
@@ -403,24 +431,30 @@ fn check_init_bounds(instance: &mut Instance, module: &Module) -> Result<(), Ins
     Ok(())
 }
 
-fn initialize_instance(
+/// Applies the module's active element and data segments to the instance.
+///
+/// When `init_imports` is `false` segments targeting imported tables and
+/// memories are skipped, which is what resetting an instance wants since it
+/// leaves imports alone.
+pub(super) fn initialize_instance(
     instance: &mut Instance,
     module: &Module,
     is_bulk_memory: bool,
+    init_imports: bool,
 ) -> Result<(), InstantiationError> {
     // If bulk memory is not enabled, bounds check the data and element segments before
     // making any changes. With bulk memory enabled, initializers are processed
     // in-order and side effects are observed up to the point of an out-of-bounds
     // initializer, so the early checking is not desired.
     if !is_bulk_memory {
-        check_init_bounds(instance, module)?;
+        check_init_bounds(instance, module, init_imports)?;
     }
 
     // Initialize the tables
-    initialize_tables(instance, module)?;
+    initialize_tables(instance, module, init_imports)?;
 
     // Initialize the memories
-    initialize_memories(instance, &module)?;
+    initialize_memories(instance, &module, init_imports)?;
 
     Ok(())
 }
@@ -569,7 +603,7 @@ unsafe impl InstanceAllocator for OnDemandInstanceAllocator {
         module: &Module,
         is_bulk_memory: bool,
     ) -> Result<(), InstantiationError> {
-        initialize_instance(handle.instance_mut(), module, is_bulk_memory)
+        initialize_instance(handle.instance_mut(), module, is_bulk_memory, true)
     }
 
     unsafe fn deallocate(&self, handle: &InstanceHandle) {
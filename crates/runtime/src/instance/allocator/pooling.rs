@@ -1090,7 +1090,7 @@ unsafe impl InstanceAllocator for PoolingInstanceAllocator {
         is_bulk_memory: bool,
     ) -> Result<(), InstantiationError> {
         let instance = handle.instance_mut();
-        initialize_instance(instance, module, is_bulk_memory)
+        initialize_instance(instance, module, is_bulk_memory, true)
     }
 
     unsafe fn deallocate(&self, handle: &InstanceHandle) {
@@ -153,6 +153,16 @@ pub trait RuntimeLinearMemory: Send + Sync {
     /// For the pooling allocator, we must be able to downcast this trait to its
     /// underlying structure.
     fn as_any_mut(&mut self) -> &mut dyn std::any::Any;
+
+    /// Resets this memory back to `initial_size` bytes, with the contents it
+    /// had when it was created.
+    ///
+    /// Memories backed by a `MemoryImageSlot` get their initial image back;
+    /// others are zeroed and `needs_init` then tells the caller to copy in
+    /// data segments again. By default memories can't be reset.
+    fn reset(&mut self, _initial_size: usize) -> Result<()> {
+        bail!("this kind of linear memory cannot be reset")
+    }
 }
 
 /// A linear memory instance.
@@ -339,6 +349,49 @@ impl RuntimeLinearMemory for MmapMemory {
     fn as_any_mut(&mut self) -> &mut dyn std::any::Any {
         self
     }
+
+    fn reset(&mut self, initial_size: usize) -> Result<()> {
+        if let Some(image) = self.memory_image.as_mut() {
+            image.reset(initial_size)?;
+        } else {
+            let base = unsafe { self.mmap.as_mut_ptr().add(self.pre_guard_size) };
+            unsafe { reset_anonymous(base, self.accessible, initial_size)? };
+        }
+        self.accessible = initial_size;
+        Ok(())
+    }
+}
+
+/// Zeroes the `accessible` bytes of anonymous memory at `base` and makes
+/// everything past `initial_size` inaccessible again.
+#[cfg(unix)]
+unsafe fn reset_anonymous(base: *mut u8, accessible: usize, initial_size: usize) -> Result<()> {
+    cfg_if::cfg_if! {
+        if #[cfg(target_os = "linux")] {
+            // Dropping the pages of a private anonymous mapping both returns
+            // them to the kernel and makes them read back as zeros.
+            rustix::mm::madvise(base.cast(), accessible, rustix::mm::Advice::LinuxDontNeed)?;
+        } else {
+            std::ptr::write_bytes(base, 0, accessible);
+        }
+    }
+    if accessible > initial_size {
+        rustix::mm::mprotect(
+            base.add(initial_size).cast(),
+            accessible - initial_size,
+            rustix::mm::MprotectFlags::empty(),
+        )?;
+    }
+    Ok(())
+}
+
+#[cfg(not(unix))]
+unsafe fn reset_anonymous(base: *mut u8, accessible: usize, initial_size: usize) -> Result<()> {
+    if accessible > initial_size {
+        bail!("resetting a memory that has grown is not supported on this platform");
+    }
+    std::ptr::write_bytes(base, 0, accessible);
+    Ok(())
 }
 
 /// A "static" memory where the lifetime of the backing memory is managed
@@ -452,6 +505,17 @@ impl RuntimeLinearMemory for StaticMemory {
     fn as_any_mut(&mut self) -> &mut dyn std::any::Any {
         self
     }
+
+    fn reset(&mut self, initial_size: usize) -> Result<()> {
+        match &mut self.memory_image {
+            Some(image) => image.reset(initial_size)?,
+            // Without an image slot there's no way to make the grown part of
+            // the pooling allocator's memory inaccessible again from here.
+            None => bail!("pooled memories can only be reset with copy-on-write initialization"),
+        }
+        self.size = initial_size;
+        Ok(())
+    }
 }
 
 /// For shared memory (and only for shared memory), this lock-version restricts
@@ -745,6 +809,29 @@ impl Memory {
         self.0.byte_size()
     }
 
+    /// Resets this memory back to `initial_size` bytes, with the contents it
+    /// had when it was created.
+    ///
+    /// If `needs_init` returns `true` afterwards then data segments
+    /// need to be copied in again.
+    pub fn reset(&mut self, initial_size: usize) -> Result<()> {
+        self.0.reset(initial_size)
+    }
+
+    /// Returns how many bytes of the accessible part of this memory are
+    /// resident in physical memory.
+    ///
+    /// Returns `None` if that can't be determined, for example on platforms
+    /// without `mincore` or for memories not backed by an `mmap`.
+    pub fn resident_byte_size(&mut self) -> Option<usize> {
+        let vmmemory = self.vmmemory();
+        let len = vmmemory.current_length();
+        if len == 0 {
+            return Some(0);
+        }
+        resident_byte_size(vmmemory.base, len)
+    }
+
     /// Returns the maximum number of pages the memory can grow to at runtime.
     ///
     /// Returns `None` if the memory is unbounded.
@@ -826,3 +913,20 @@ impl Memory {
         }
     }
 }
+
+#[cfg(unix)]
+fn resident_byte_size(base: *mut u8, len: usize) -> Option<usize> {
+    let page_size = crate::page_size();
+    let mut pages = vec![0u8; (len + page_size - 1) / page_size];
+    let rc = unsafe { libc::mincore(base.cast(), len, pages.as_mut_ptr().cast()) };
+    if rc != 0 {
+        return None;
+    }
+    let resident = pages.iter().filter(|p| **p & 1 != 0).count();
+    Some((resident * page_size).min(len))
+}
+
+#[cfg(not(unix))]
+fn resident_byte_size(_base: *mut u8, _len: usize) -> Option<usize> {
+    None
+}
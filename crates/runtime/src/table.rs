@@ -7,7 +7,7 @@ use crate::{Store, VMExternRef};
 use anyhow::{bail, format_err, Error, Result};
 use std::convert::{TryFrom, TryInto};
 use std::ops::Range;
-use std::ptr;
+use std::{mem, ptr};
 use wasmtime_environ::{TablePlan, TrapCode, WasmType, FUNCREF_INIT_BIT, FUNCREF_MASK};
 
 /// An element going into or coming out of a table.
@@ -287,6 +287,24 @@ impl Table {
         Ok(())
     }
 
+    /// Resets this table to `size` elements which are all null, or
+    /// uninitialized for lazily-initialized funcref tables, as when it was
+    /// created.
+    ///
+    /// `size` must not be larger than the table's current size.
+    pub fn reset(&mut self, size: u32) {
+        assert!(size <= self.size());
+        let ty = self.element_type();
+        for element in self.elements_mut() {
+            let old = mem::replace(element, 0);
+            drop(unsafe { TableElement::from_table_value(ty, old) });
+        }
+        match self {
+            Table::Static { size: cur, .. } => *cur = size,
+            Table::Dynamic { elements, .. } => elements.truncate(size as usize),
+        }
+    }
+
     /// Fill `table[dst..dst + len]` with `val`.
     ///
     /// Returns a trap error on out-of-bounds accesses.
@@ -303,6 +321,24 @@ impl Table {
         debug_assert!(self.type_matches(&val));
 
         let ty = self.element_type();
+        if let TableElementType::Extern = ty {
+            // Take all the new references up front with one atomic operation,
+            // and release the old ones a run at a time, instead of cloning
+            // and dropping element by element.
+            let val = unsafe { val.into_table_value() };
+            let elements = &mut self.elements_mut()[start..end];
+            if val != 0 {
+                unsafe {
+                    match elements.len() {
+                        0 => VMExternRef::drop_raw_n(val as *mut u8, 1),
+                        n => VMExternRef::clone_raw_n(val as *mut u8, n - 1),
+                    }
+                }
+            }
+            unsafe { drop_externref_runs(elements) };
+            elements.fill(val);
+            return Ok(());
+        }
         if let Some((last, elements)) = self.elements_mut()[start..end].split_last_mut() {
             for e in elements {
                 Self::set_raw(ty, e, val.clone());
@@ -383,6 +419,69 @@ impl Table {
             .map(|p| unsafe { TableElement::clone_from_table_value(self.element_type(), *p) })
     }
 
+    /// Clones the `externref`s in `table[start..start + out.len()]` into
+    /// `out`, dropping whatever `out` held before.
+    ///
+    /// Reference counts are adjusted once per run of identical references
+    /// rather than once per element.
+    ///
+    /// Returns a trap error on out-of-bounds accesses, in which case `out` is
+    /// left untouched.
+    pub fn get_externrefs(
+        &self,
+        start: u32,
+        out: &mut [Option<VMExternRef>],
+    ) -> Result<(), TrapCode> {
+        debug_assert!(self.element_type() == TableElementType::Extern);
+        let elements = self.elements();
+        let elements = (start as usize)
+            .checked_add(out.len())
+            .and_then(|end| elements.get(start as usize..end))
+            .ok_or(TrapCode::TableOutOfBounds)?;
+
+        unsafe {
+            for_each_externref_run(elements, |ptr, n| VMExternRef::clone_raw_n(ptr, n));
+            for (slot, raw) in out.iter_mut().zip(elements) {
+                *slot = match *raw {
+                    0 => None,
+                    raw => Some(VMExternRef::from_raw(raw as *mut u8)),
+                };
+            }
+        }
+        Ok(())
+    }
+
+    /// Moves the `externref`s in `vals` into `table[start..start +
+    /// vals.len()]`, leaving `None` behind in `vals`.
+    ///
+    /// The references previously in the table are released once per run of
+    /// identical references rather than once per element, and the new ones
+    /// are moved in without touching their reference counts.
+    ///
+    /// Returns a trap error on out-of-bounds accesses, in which case `vals`
+    /// is left untouched.
+    pub fn set_externrefs(
+        &mut self,
+        start: u32,
+        vals: &mut [Option<VMExternRef>],
+    ) -> Result<(), TrapCode> {
+        debug_assert!(self.element_type() == TableElementType::Extern);
+        let elements = self.elements_mut();
+        let end = (start as usize)
+            .checked_add(vals.len())
+            .filter(|end| *end <= elements.len())
+            .ok_or(TrapCode::TableOutOfBounds)?;
+        let elements = &mut elements[start as usize..end];
+
+        unsafe {
+            drop_externref_runs(elements);
+            for (raw, val) in elements.iter_mut().zip(vals) {
+                *raw = val.take().map_or(0, |r| r.into_raw() as usize);
+            }
+        }
+        Ok(())
+    }
+
     /// Set reference to the specified element.
     ///
     /// # Errors
@@ -507,13 +606,15 @@ impl Table {
                     .copy_from_slice(&src_table.elements()[src_range]);
             }
             TableElementType::Extern => {
-                // We need to clone each `externref`
-                let dst = dst_table.elements_mut();
-                let src = src_table.elements();
-                for (s, d) in src_range.zip(dst_range) {
-                    let elem = unsafe { TableElement::clone_from_table_value(ty, src[s]) };
-                    Self::set_raw(ty, &mut dst[d], elem);
+                // Take the new references and release the overwritten ones a
+                // run at a time, then copy the raw pointers over.
+                let dst = &mut dst_table.elements_mut()[dst_range];
+                let src = &src_table.elements()[src_range];
+                unsafe {
+                    for_each_externref_run(src, |ptr, n| VMExternRef::clone_raw_n(ptr, n));
+                    drop_externref_runs(dst);
                 }
+                dst.copy_from_slice(src);
             }
         }
     }
@@ -527,24 +628,45 @@ impl Table {
                 dst.copy_within(src_range, dst_range.start);
             }
             TableElementType::Extern => {
-                // We need to clone each `externref` while handling overlapping
-                // ranges
-                if dst_range.start <= src_range.start {
-                    for (s, d) in src_range.zip(dst_range) {
-                        let elem = unsafe { TableElement::clone_from_table_value(ty, dst[s]) };
-                        Self::set_raw(ty, &mut dst[d], elem);
-                    }
-                } else {
-                    for (s, d) in src_range.rev().zip(dst_range.rev()) {
-                        let elem = unsafe { TableElement::clone_from_table_value(ty, dst[s]) };
-                        Self::set_raw(ty, &mut dst[d], elem);
-                    }
+                // Every source reference is taken before any overwritten one
+                // is released, so overlapping ranges can't free a reference
+                // that's about to be copied, and then it's just a memmove.
+                unsafe {
+                    for_each_externref_run(&dst[src_range.clone()], |ptr, n| {
+                        VMExternRef::clone_raw_n(ptr, n)
+                    });
+                    drop_externref_runs(&dst[dst_range.clone()]);
                 }
+                dst.copy_within(src_range, dst_range.start);
             }
         }
     }
 }
 
+/// Calls `f` with each non-null raw `externref` in `elements` and the number
+/// of consecutive times it occurs there.
+fn for_each_externref_run(elements: &[usize], mut f: impl FnMut(*mut u8, usize)) {
+    let mut elements = elements;
+    while let Some(&raw) = elements.first() {
+        let n = elements.iter().take_while(|e| **e == raw).count();
+        if raw != 0 {
+            f(raw as *mut u8, n);
+        }
+        elements = &elements[n..];
+    }
+}
+
+/// Releases the reference held by each raw `externref` in `elements`, one
+/// atomic operation per run of identical references.
+///
+/// # Safety
+///
+/// `elements` must be owned `externref` table slots which are overwritten
+/// before they're read again.
+unsafe fn drop_externref_runs(elements: &[usize]) {
+    for_each_externref_run(elements, |ptr, n| VMExternRef::drop_raw_n(ptr, n));
+}
+
 impl Drop for Table {
     fn drop(&mut self) {
         let ty = self.element_type();
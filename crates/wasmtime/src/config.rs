@@ -100,6 +100,7 @@ pub struct Config {
     pub(crate) features: WasmFeatures,
     pub(crate) wasm_backtrace: bool,
     pub(crate) wasm_backtrace_details_env_used: bool,
+    pub(crate) wasm_backtrace_lazy: bool,
     pub(crate) native_unwind_info: bool,
     #[cfg(feature = "async")]
     pub(crate) async_stack_size: usize,
@@ -187,6 +188,7 @@ impl Config {
             max_wasm_stack: 512 * 1024,
             wasm_backtrace: true,
             wasm_backtrace_details_env_used: false,
+            wasm_backtrace_lazy: false,
             native_unwind_info: true,
             features: WasmFeatures::default(),
             #[cfg(feature = "async")]
@@ -397,6 +399,24 @@ impl Config {
         self
     }
 
+    /// Configures whether the frames of a `Trap`'s backtrace are symbolized
+    /// when the trap happens or on first use.
+    ///
+    /// When enabled, a trap only records the program counters of its wasm
+    /// frames, and the [`FrameInfo`](crate::FrameInfo) for each frame is
+    /// computed the first time [`crate::Trap::trace()`] (or `Display`) is
+    /// used. Traps which are only inspected for their code or exit status,
+    /// such as guests that exit through a trap as control flow, then skip
+    /// symbolization entirely. The trap keeps the modules of its frames alive
+    /// until it's dropped.
+    ///
+    /// This has no effect if [`Config::wasm_backtrace`] is disabled. By
+    /// default this option is `false`.
+    pub fn wasm_backtrace_lazy(&mut self, enable: bool) -> &mut Self {
+        self.wasm_backtrace_lazy = enable;
+        self
+    }
+
     /// Configures whether backtraces in `Trap` will parse debug info in the wasm file to
     /// have filename/line number information.
     ///
@@ -545,6 +545,83 @@ impl Table {
         }
     }
 
+    /// Reads `out.len()` elements of this `externref` table, starting at
+    /// `index`, into `out`.
+    ///
+    /// This is equivalent to calling [`Table::get`] for each element, but
+    /// reference counts are adjusted once per run of identical references
+    /// instead of once per element.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if this isn't an `externref` table or if the range is
+    /// out of bounds, in which case `out` is left untouched.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this table.
+    pub fn get_externrefs(
+        &self,
+        mut store: impl AsContextMut,
+        index: u32,
+        out: &mut [Option<ExternRef>],
+    ) -> Result<()> {
+        let store = store.as_context_mut().0;
+        if self.ty(&store).element() != ValType::ExternRef {
+            bail!("table does not contain `externref` elements");
+        }
+        let table = self.wasmtime_table(store, std::iter::empty());
+        // `ExternRef` is a `#[repr(transparent)]` wrapper of `VMExternRef`.
+        let out = unsafe {
+            &mut *(out as *mut [Option<ExternRef>] as *mut [Option<runtime::VMExternRef>])
+        };
+        unsafe {
+            (*table)
+                .get_externrefs(index, out)
+                .map_err(|c| Trap::new_wasm(c, None))?;
+        }
+        Ok(())
+    }
+
+    /// Moves the references in `vals` into this `externref` table, starting
+    /// at `index`, leaving `None` behind in `vals`.
+    ///
+    /// This is equivalent to calling [`Table::set`] for each element, but the
+    /// new references are moved in without touching their reference counts
+    /// and the overwritten ones are released once per run of identical
+    /// references.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if this isn't an `externref` table or if the range is
+    /// out of bounds, in which case `vals` is left untouched.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this table.
+    pub fn set_externrefs(
+        &self,
+        mut store: impl AsContextMut,
+        index: u32,
+        vals: &mut [Option<ExternRef>],
+    ) -> Result<()> {
+        let store = store.as_context_mut().0;
+        if self.ty(&store).element() != ValType::ExternRef {
+            bail!("table does not contain `externref` elements");
+        }
+        let table = self.wasmtime_table(store, std::iter::empty());
+        // `ExternRef` is a `#[repr(transparent)]` wrapper of `VMExternRef`.
+        let vals = unsafe {
+            &mut *(vals as *mut [Option<ExternRef>] as *mut [Option<runtime::VMExternRef>])
+        };
+        unsafe {
+            (*table)
+                .set_externrefs(index, vals)
+                .map_err(|c| Trap::new_wasm(c, None))?;
+        }
+        Ok(())
+    }
+
     /// Returns the current size of this table.
     ///
     /// # Panics
@@ -711,6 +711,15 @@ impl Func {
         self.load_ty(&store.as_context().0)
     }
 
+    /// Returns whether `store` owns this function.
+    ///
+    /// Methods such as [`Func::ty`] and [`Func::call_unchecked`] panic when
+    /// handed a store that doesn't own the function, so callers that can't
+    /// rule that out ahead of time can check this first.
+    pub fn belongs_to(&self, store: impl AsContext) -> bool {
+        self.comes_from_same_store(store.as_context().0)
+    }
+
     /// Forcibly loads the type of this function from the `Engine`.
     ///
     /// Note that this is a somewhat expensive method since it requires taking a
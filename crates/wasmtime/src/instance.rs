@@ -357,6 +357,61 @@ impl Instance {
         Ok(())
     }
 
+    /// Resets this instance back to the state it was in right after it was
+    /// instantiated, so the same store and instance can be reused to run a
+    /// fresh request without paying for a new instantiation.
+    ///
+    /// Memories defined by this instance are shrunk back to their initial
+    /// size and their contents restored. When copy-on-write memory
+    /// initialization is in use the pages are remapped to the module's
+    /// prebuilt image, otherwise the memory is discarded (with
+    /// `madvise(MADV_DONTNEED)` where available) and the data segments are
+    /// copied in again. Defined tables and globals are re-initialized, any
+    /// dropped data or element segments become available again, and finally
+    /// the module's start function, if any, is re-run.
+    ///
+    /// Imported items, host state in the store, and any state kept outside of
+    /// WebAssembly (such as WASI file descriptors) are not reset. Active data
+    /// and element segments targeting imported memories and tables aren't
+    /// applied again either, so whatever was written to them since
+    /// instantiation stays in place.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if WebAssembly is currently executing in this store,
+    /// if a memory can't be reset (for example shared memories or pooled
+    /// memories without a copy-on-write image), or if re-initialization or
+    /// the start function traps. Modules with a start function can't be reset
+    /// in stores with async support enabled.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this instance.
+    pub fn reset(&self, mut store: impl AsContextMut) -> Result<()> {
+        let mut store = store.as_context_mut();
+        if unsafe { *store.0.runtime_limits().stack_limit.get() } != usize::MAX {
+            bail!("cannot reset an instance while WebAssembly is executing");
+        }
+        let id = store.0.store_data()[self.0].id;
+        let start = store.0.instance(id).module().start_func;
+        if start.is_some() && store.0.async_support() {
+            bail!("cannot reset an instance with a start function in an async store");
+        }
+
+        let bulk_memory = store.0.engine().config().features.bulk_memory;
+        unsafe { store.0.instance_mut(id).reset(bulk_memory) }.map_err(|e| -> Error {
+            match e {
+                InstantiationError::Trap(trap) => Trap::new_wasm(trap, None).into(),
+                other => other.into(),
+            }
+        })?;
+
+        if let Some(start) = start {
+            self.start_raw(&mut store, start)?;
+        }
+        Ok(())
+    }
+
     /// Returns the list of exported items from this [`Instance`].
     ///
     /// # Panics
@@ -417,7 +417,10 @@ pub use crate::module::Module;
 pub use crate::r#ref::ExternRef;
 #[cfg(feature = "async")]
 pub use crate::store::CallHookHandler;
-pub use crate::store::{AsContext, AsContextMut, CallHook, Store, StoreContext, StoreContextMut};
+pub use crate::store::{
+    AsContext, AsContextMut, CallHook, GcStats, LinearMemoryStats, Store, StoreContext,
+    StoreContextMut, StoreMemoryStats,
+};
 pub use crate::trap::*;
 pub use crate::types::*;
 pub use crate::values::*;
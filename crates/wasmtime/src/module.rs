@@ -872,6 +872,18 @@ impl Module {
         self.compiled_module().image_range()
     }
 
+    /// Returns whether this module's compilation image is mapped directly
+    /// from the file it was deserialized from.
+    ///
+    /// This is the case for [`Module::deserialize_file`], where the image is
+    /// a private read-only mapping of the file whose code pages are never
+    /// written to. Those pages are then shared through the page cache with
+    /// every other process that maps the same file. Modules compiled or
+    /// deserialized from in-memory bytes live in anonymous memory instead.
+    pub fn image_is_file_backed(&self) -> bool {
+        self.compiled_module().mmap().original_file().is_some()
+    }
+
     /// Force initialization of copy-on-write images to happen here-and-now
     /// instead of when they're requested during first instantiation.
     ///
@@ -893,6 +905,31 @@ impl Module {
         self.inner.memory_images()?;
         Ok(())
     }
+
+    /// Returns whether instantiating this module maps its memories from a
+    /// copy-on-write image instead of copying in its data segments.
+    ///
+    /// This is `false` when [copy-on-write memory
+    /// initialization](crate::Config::memory_init_cow) is disabled, or when
+    /// the module's data segments couldn't be laid out as a static image at
+    /// compile time, for example because their offsets depend on imported
+    /// globals or because the image would be too sparse. It's also `false`
+    /// when none of the memories defined by the module have any data to map.
+    ///
+    /// Like [`Module::initialize_copy_on_write_image`] this creates the
+    /// image if it doesn't exist yet.
+    pub fn uses_copy_on_write_image(&self) -> Result<bool> {
+        let images = match self.inner.memory_images()? {
+            Some(images) => images,
+            None => return Ok(false),
+        };
+        let module = self.env_module();
+        Ok(module
+            .memory_plans
+            .keys()
+            .filter_map(|index| module.defined_memory_index(index))
+            .any(|index| images.get_memory_image(index).is_some()))
+    }
 }
 
 impl ModuleInner {
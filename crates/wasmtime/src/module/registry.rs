@@ -54,7 +54,9 @@ impl ModuleRegistry {
         self.module(pc).map(|(m, _)| m.module_info())
     }
 
-    fn module(&self, pc: usize) -> Option<(&Module, usize)> {
+    /// Fetches the registered module containing a program counter value and
+    /// the offset of the program counter within its text section.
+    pub(crate) fn module(&self, pc: usize) -> Option<(&Module, usize)> {
         match self.module_or_component(pc)? {
             (ModuleOrComponent::Module(m), offset) => Some((m, offset)),
             #[cfg(feature = "component-model")]
@@ -70,6 +72,15 @@ impl ModuleRegistry {
         Some((module, pc - *start))
     }
 
+    /// Returns the total size, in bytes, of the compiled code registered with
+    /// this registry.
+    pub(crate) fn code_bytes(&self) -> usize {
+        self.modules_with_code
+            .iter()
+            .map(|(end, (start, _))| end - start + 1)
+            .sum()
+    }
+
     /// Registers a new module with the registry.
     pub fn register_module(&mut self, module: &Module) {
         let compiled_module = module.compiled_module();
@@ -93,6 +93,7 @@ use std::ptr;
 use std::sync::atomic::AtomicU64;
 use std::sync::Arc;
 use std::task::{Context, Poll};
+use std::time::{Duration, Instant};
 use wasmtime_runtime::{
     InstanceAllocationRequest, InstanceAllocator, InstanceHandle, ModuleInfo,
     OnDemandInstanceAllocator, SignalHandler, StorePtr, VMCallerCheckedAnyfunc, VMContext,
@@ -405,6 +406,73 @@ where
     }
 }
 
+/// An estimate of the memory used by a [`Store`], returned by
+/// [`Store::memory_stats`].
+#[derive(Debug, Clone, Default)]
+pub struct StoreMemoryStats {
+    /// Statistics for each linear memory defined in the store, including ones
+    /// created by the host, in the order they were created.
+    pub memories: Vec<LinearMemoryStats>,
+    /// Bytes of host memory used for the elements of tables defined in the
+    /// store.
+    pub table_bytes: usize,
+    /// Bytes of host memory used for the runtime state of the store's
+    /// instances, including their `VMContext`s.
+    pub instance_bytes: usize,
+    /// Size of the compiled code of the modules instantiated in the store.
+    ///
+    /// This code is shared with every other store using the same modules, so
+    /// it shouldn't be summed across stores.
+    pub code_bytes: usize,
+}
+
+/// Statistics about the garbage collection of `ExternRef`s in a [`Store`],
+/// returned by [`Store::gc_step`] and [`Store::gc_stats`].
+#[derive(Debug, Clone, Copy, Default)]
+pub struct GcStats {
+    /// The number of collections performed, including the ones triggered
+    /// automatically.
+    pub collections: u64,
+    /// The number of `externref` roots found in WebAssembly frames on the
+    /// stack.
+    pub roots_scanned: u64,
+    /// The number of references no longer used by WebAssembly that were
+    /// dropped.
+    pub refs_released: u64,
+    /// How many of the released references were the last reference to their
+    /// data, which was then freed.
+    pub refs_freed: u64,
+    /// The number of unused references still waiting to be dropped by a later
+    /// collection, see [`Store::set_gc_release_budget`].
+    pub refs_pending: u64,
+    /// The time spent collecting.
+    pub pause: Duration,
+}
+
+impl From<wasmtime_runtime::GcStats> for GcStats {
+    fn from(stats: wasmtime_runtime::GcStats) -> GcStats {
+        GcStats {
+            collections: stats.collections,
+            roots_scanned: stats.roots_scanned,
+            refs_released: stats.refs_released,
+            refs_freed: stats.refs_freed,
+            refs_pending: stats.refs_pending,
+            pause: stats.pause,
+        }
+    }
+}
+
+/// Statistics for a single linear memory, see [`StoreMemoryStats`].
+#[derive(Debug, Clone)]
+pub struct LinearMemoryStats {
+    /// The current byte size of the memory, which is the amount of it
+    /// WebAssembly may have touched.
+    pub byte_size: usize,
+    /// How many of those bytes are resident in physical memory, if requested
+    /// and supported by the platform.
+    pub resident_bytes: Option<usize>,
+}
+
 /// Used to associate instances with the store.
 ///
 /// This is needed to track if the instance was allocated explicitly with the on-demand
@@ -741,6 +809,70 @@ impl<T> Store<T> {
         self.inner.gc()
     }
 
+    /// Performs one bounded step of `ExternRef` garbage collection.
+    ///
+    /// Like [`Store::gc`] this finds the references still used by
+    /// WebAssembly frames on the stack, but at most `max_refs` of the unused
+    /// references are then dropped, stopping early once `max_time` has
+    /// elapsed. Running the destructors of dropped references is usually the
+    /// bulk of a collection's cost, so this bounds the pause. References which
+    /// aren't dropped are kept for later steps or collections.
+    ///
+    /// Returns the statistics for this step alone.
+    pub fn gc_step(&mut self, max_refs: usize, max_time: Option<Duration>) -> GcStats {
+        self.inner.gc_step(max_refs, max_time)
+    }
+
+    /// Limits how many unused `ExternRef`s each collection drops.
+    ///
+    /// This applies to [`Store::gc`] as well as the collections which happen
+    /// automatically when WebAssembly has used up the internal buffer of
+    /// references, see [`Store::set_gc_trigger`]. References beyond the budget
+    /// are kept until a later collection or [`Store::gc_step`], which spreads
+    /// the work of dropping a burst of references over several collections.
+    ///
+    /// The references waiting to be dropped aren't bounded: if WebAssembly
+    /// keeps taking references faster than the budget drops them, the backlog
+    /// grows without limit. Hosts using a small budget should keep an eye on
+    /// [`GcStats::refs_pending`] and drain it with [`Store::gc_step`].
+    ///
+    /// `None`, the default, drops every unused reference in each collection.
+    pub fn set_gc_release_budget(&mut self, budget: Option<usize>) {
+        self.inner
+            .externref_activations_table
+            .set_release_budget(budget);
+    }
+
+    /// Sets how many `ExternRef`s WebAssembly may take from the host, or read
+    /// from tables and globals, before a collection is triggered
+    /// automatically.
+    ///
+    /// Larger values mean fewer automatic collections, at the cost of keeping
+    /// unused references alive for longer. Values smaller than the default of
+    /// 512 are rounded up. The new value takes effect after the next
+    /// collection.
+    pub fn set_gc_trigger(&mut self, entries: usize) {
+        self.inner
+            .externref_activations_table
+            .set_gc_trigger(entries);
+    }
+
+    /// Returns the totals of every `ExternRef` collection performed in this
+    /// store so far.
+    pub fn gc_stats(&self) -> GcStats {
+        self.inner.externref_activations_table.gc_stats().into()
+    }
+
+    /// Returns an estimate of the memory used by this store.
+    ///
+    /// Linear memory and table sizes are read from the store's bookkeeping, so
+    /// this is cheap unless `resident` is `true`, in which case the operating
+    /// system is also asked how much of each linear memory is resident (with
+    /// `mincore` on Unix). See [`StoreMemoryStats`] for what's reported.
+    pub fn memory_stats(&mut self, resident: bool) -> StoreMemoryStats {
+        self.inner.memory_stats(resident)
+    }
+
     /// Returns the amount of fuel consumed by this store's execution so far.
     ///
     /// If fuel consumption is not enabled via
@@ -991,6 +1123,14 @@ impl<'a, T> StoreContext<'a, T> {
     pub fn fuel_consumed(&self) -> Option<u64> {
         self.0.fuel_consumed()
     }
+
+    /// Returns the totals of every `ExternRef` collection performed in this
+    /// store so far.
+    ///
+    /// For more information see [`Store::gc_stats`].
+    pub fn gc_stats(&self) -> GcStats {
+        self.0.externref_activations_table.gc_stats().into()
+    }
 }
 
 impl<'a, T> StoreContextMut<'a, T> {
@@ -1020,6 +1160,45 @@ impl<'a, T> StoreContextMut<'a, T> {
         self.0.gc()
     }
 
+    /// Performs one bounded step of `ExternRef` garbage collection.
+    ///
+    /// For more information see [`Store::gc_step`].
+    pub fn gc_step(&mut self, max_refs: usize, max_time: Option<Duration>) -> GcStats {
+        self.0.gc_step(max_refs, max_time)
+    }
+
+    /// Limits how many unused `ExternRef`s each collection drops.
+    ///
+    /// For more information see [`Store::set_gc_release_budget`].
+    pub fn set_gc_release_budget(&mut self, budget: Option<usize>) {
+        self.0
+            .externref_activations_table
+            .set_release_budget(budget);
+    }
+
+    /// Sets how many `ExternRef`s may be handed to WebAssembly before a
+    /// collection is triggered automatically.
+    ///
+    /// For more information see [`Store::set_gc_trigger`].
+    pub fn set_gc_trigger(&mut self, entries: usize) {
+        self.0.externref_activations_table.set_gc_trigger(entries);
+    }
+
+    /// Returns the totals of every `ExternRef` collection performed in this
+    /// store so far.
+    ///
+    /// For more information see [`Store::gc_stats`].
+    pub fn gc_stats(&self) -> GcStats {
+        self.0.externref_activations_table.gc_stats().into()
+    }
+
+    /// Returns an estimate of the memory used by this store.
+    ///
+    /// For more information see [`Store::memory_stats`].
+    pub fn memory_stats(&mut self, resident: bool) -> StoreMemoryStats {
+        self.0.memory_stats(resident)
+    }
+
     /// Returns the fuel consumed by this store.
     ///
     /// For more information see [`Store::fuel_consumed`].
@@ -1209,12 +1388,52 @@ impl StoreOpaque {
         &mut self.externref_activations_table
     }
 
+    pub fn memory_stats(&mut self, resident: bool) -> StoreMemoryStats {
+        let mut stats = StoreMemoryStats {
+            code_bytes: self.modules.code_bytes(),
+            ..StoreMemoryStats::default()
+        };
+        for instance in self.instances.iter_mut() {
+            stats.instance_bytes += instance.handle.allocation_size();
+            for table in instance.handle.defined_tables() {
+                stats.table_bytes += table.size() as usize * mem::size_of::<*mut u8>();
+            }
+            for memory in instance.handle.defined_memories_mut() {
+                let byte_size = memory.byte_size();
+                let resident_bytes = if resident {
+                    memory.resident_byte_size()
+                } else {
+                    None
+                };
+                stats.memories.push(LinearMemoryStats {
+                    byte_size,
+                    resident_bytes,
+                });
+            }
+        }
+        stats
+    }
+
     pub fn gc(&mut self) {
         // For this crate's API, we ensure that `set_stack_canary` invariants
         // are upheld for all host-->Wasm calls.
         unsafe { wasmtime_runtime::gc(&self.modules, &mut self.externref_activations_table) }
     }
 
+    pub fn gc_step(&mut self, max_refs: usize, max_time: Option<Duration>) -> GcStats {
+        let deadline = max_time.map(|t| Instant::now() + t);
+        // See `gc` above for why this is safe.
+        let stats = unsafe {
+            wasmtime_runtime::gc_with_budget(
+                &self.modules,
+                &mut self.externref_activations_table,
+                Some(max_refs),
+                deadline,
+            )
+        };
+        stats.into()
+    }
+
     /// Looks up the corresponding `VMTrampoline` which can be used to enter
     /// wasm given an anyfunc function pointer.
     ///
@@ -136,9 +136,11 @@ impl fmt::Display for TrapCode {
     }
 }
 
-#[derive(Debug)]
 pub(crate) struct TrapBacktrace {
-    wasm_trace: Vec<FrameInfo>,
+    wasm_trace: OnceCell<Vec<FrameInfo>>,
+    /// Frames whose symbolization is deferred until the trace is first
+    /// requested, see `Config::wasm_backtrace_lazy`.
+    unsymbolized: Vec<(Module, usize)>,
     runtime_trace: wasmtime_runtime::Backtrace,
     hint_wasm_backtrace_details_env: bool,
 }
@@ -149,7 +151,14 @@ impl TrapBacktrace {
         runtime_trace: wasmtime_runtime::Backtrace,
         trap_pc: Option<usize>,
     ) -> Self {
-        let mut wasm_trace = Vec::<FrameInfo>::with_capacity(runtime_trace.frames().len());
+        let lazy = store.engine().config().wasm_backtrace_lazy;
+        let mut unsymbolized = Vec::new();
+        let mut wasm_trace = Vec::<FrameInfo>::new();
+        if lazy {
+            unsymbolized.reserve(runtime_trace.frames().len());
+        } else {
+            wasm_trace.reserve(runtime_trace.frames().len());
+        }
         let mut hint_wasm_backtrace_details_env = false;
         let wasm_backtrace_details_env_used =
             store.engine().config().wasm_backtrace_details_env_used;
@@ -197,8 +206,14 @@ impl TrapBacktrace {
             // Some(..)` instead of the `unwrap` you might otherwise expect and
             // we ignore frames from modules that were not registered in this
             // store's module registry.
-            if let Some((info, module)) = store.modules().lookup_frame_info(pc_to_lookup) {
-                wasm_trace.push(info);
+            if let Some((module, offset)) = store.modules().module(pc_to_lookup) {
+                if lazy {
+                    unsymbolized.push((module.clone(), offset));
+                } else if let Some(info) = FrameInfo::new(module, offset) {
+                    wasm_trace.push(info);
+                } else {
+                    continue;
+                }
 
                 // If this frame has unparsed debug information and the
                 // store's configuration indicates that we were
@@ -214,11 +229,25 @@ impl TrapBacktrace {
         }
 
         Self {
-            wasm_trace,
+            wasm_trace: if lazy {
+                OnceCell::new()
+            } else {
+                OnceCell::with_value(wasm_trace)
+            },
+            unsymbolized,
             runtime_trace,
             hint_wasm_backtrace_details_env,
         }
     }
+
+    fn wasm_trace(&self) -> &[FrameInfo] {
+        self.wasm_trace.get_or_init(|| {
+            self.unsymbolized
+                .iter()
+                .filter_map(|(module, offset)| FrameInfo::new(module, *offset))
+                .collect()
+        })
+    }
 }
 
 struct TrapInner {
@@ -255,9 +284,11 @@ impl Trap {
     // Same safety requirements and caveats as
     // `wasmtime_runtime::raise_user_trap`.
     pub(crate) unsafe fn raise(error: anyhow::Error) -> ! {
-        let needs_backtrace = error
-            .downcast_ref::<Trap>()
-            .map_or(true, |trap| trap.trace().is_none());
+        // Explicit exits are normal program termination rather than a fault,
+        // so don't pay for walking the stack to describe where they happened.
+        let needs_backtrace = error.downcast_ref::<Trap>().map_or(true, |trap| {
+            trap.trace().is_none() && trap.i32_exit_status().is_none()
+        });
         wasmtime_runtime::raise_user_trap(error, needs_backtrace)
     }
 
@@ -358,7 +389,7 @@ impl Trap {
             .backtrace
             .get()
             .as_ref()
-            .map(|bt| bt.wasm_trace.as_slice())
+            .map(|bt| bt.wasm_trace())
     }
 
     /// Code of a trap that happened while executing a WASM instruction.
@@ -390,7 +421,7 @@ impl fmt::Debug for Trap {
         let mut f = f.debug_struct("Trap");
         f.field("reason", &self.inner.reason);
         if let Some(backtrace) = self.inner.backtrace.get() {
-            f.field("wasm_trace", &backtrace.wasm_trace)
+            f.field("wasm_trace", &backtrace.wasm_trace())
                 .field("runtime_trace", &backtrace.runtime_trace);
         }
         f.finish()
@@ -0,0 +1,221 @@
+/*
+Example of calling WebAssembly asynchronously from C, with both the host and
+the guest giving control back to the caller before the call completes.
+
+You can compile and run this example on Linux with:
+
+   cargo build --release -p wasmtime-c-api
+   cc examples/async.c \
+       -I crates/c-api/include \
+       -I crates/c-api/wasm-c-api/include \
+       target/release/libwasmtime.a \
+       -lpthread -ldl -lm \
+       -o async
+   ./async
+
+Note that on Windows and macOS the command will be similar, but you'll need
+to tweak the `-lpthread` and such annotations.
+
+You can also build using cmake:
+
+mkdir build && cd build && cmake .. && cmake --build . --target wasmtime-async
+*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wasm.h>
+#include <wasmtime.h>
+
+static void exit_with_error(const char *message, wasmtime_error_t *error, wasm_trap_t *trap);
+
+// State of the one `host.sleep` call in flight.
+typedef struct {
+  int polls_left;
+  int32_t answer;
+  wasmtime_val_t *results;
+} sleep_state;
+
+static sleep_state sleeping;
+
+static bool sleep_ready(void *env) {
+  sleep_state *state = env;
+  if (state->polls_left-- > 0)
+    return false;
+  state->results[0].kind = WASMTIME_I32;
+  state->results[0].of.i32 = state->answer;
+  return true;
+}
+
+// `host.sleep(n)` answers `n + 1` after being polled `n` times, or traps
+// straight away if `n` is negative.
+static void sleep_callback(
+    void *env,
+    wasmtime_caller_t *caller,
+    const wasmtime_val_t *args,
+    size_t nargs,
+    wasmtime_val_t *results,
+    size_t nresults,
+    wasm_trap_t **trap_ret,
+    wasmtime_async_continuation_t *continuation_ret) {
+  int32_t n = args[0].of.i32;
+  if (n < 0) {
+    const char *msg = "negative sleep";
+    *trap_ret = wasmtime_trap_new(msg, strlen(msg));
+    return;
+  }
+  sleeping.polls_left = n;
+  sleeping.answer = n + 1;
+  sleeping.results = results;
+  continuation_ret->callback = sleep_ready;
+  continuation_ret->env = &sleeping;
+  continuation_ret->finalizer = NULL;
+}
+
+// Polls `future` to completion and returns how many polls that took.
+static int run_to_completion(wasmtime_call_future_t *future) {
+  int polls = 1;
+  while (!wasmtime_call_future_poll(future))
+    polls++;
+  wasmtime_call_future_delete(future);
+  return polls;
+}
+
+static int call(wasmtime_context_t *context, wasmtime_func_t *func,
+                wasmtime_val_t *args, size_t nargs,
+                wasmtime_val_t *results, size_t nresults,
+                wasm_trap_t **trap) {
+  wasmtime_error_t *error = NULL;
+  *trap = NULL;
+  int polls = run_to_completion(wasmtime_func_call_async(
+      context, func, args, nargs, results, nresults, trap, &error));
+  if (error != NULL)
+    exit_with_error("failed to call function", error, NULL);
+  return polls;
+}
+
+int main() {
+  wasmtime_error_t *error = NULL;
+  wasm_trap_t *trap = NULL;
+
+  wasm_config_t *config = wasm_config_new();
+  assert(config != NULL);
+  wasmtime_config_async_support_set(config, true);
+  wasmtime_config_consume_fuel_set(config, true);
+
+  wasm_engine_t *engine = wasm_engine_new_with_config(config);
+  assert(engine != NULL);
+  wasmtime_store_t *store = wasmtime_store_new(engine, NULL, NULL);
+  assert(store != NULL);
+  wasmtime_context_t *context = wasmtime_store_context(store);
+
+  // Yield back to the poller every 1000 units of fuel, forever.
+  error = wasmtime_context_add_fuel(context, 1000);
+  if (error != NULL)
+    exit_with_error("failed to add fuel", error, NULL);
+  wasmtime_context_out_of_fuel_async_yield(context, UINT64_MAX, 1000);
+
+  // Load our input file to parse it next
+  FILE* file = fopen("examples/async.wat", "r");
+  if (!file) {
+    printf("> Error loading file!\n");
+    return 1;
+  }
+  fseek(file, 0L, SEEK_END);
+  size_t file_size = ftell(file);
+  fseek(file, 0L, SEEK_SET);
+  wasm_byte_vec_t wat;
+  wasm_byte_vec_new_uninitialized(&wat, file_size);
+  if (fread(wat.data, file_size, 1, file) != 1) {
+    printf("> Error loading module!\n");
+    return 1;
+  }
+  fclose(file);
+
+  wasm_byte_vec_t wasm;
+  error = wasmtime_wat2wasm(wat.data, wat.size, &wasm);
+  if (error != NULL)
+    exit_with_error("failed to parse wat", error, NULL);
+  wasm_byte_vec_delete(&wat);
+
+  wasmtime_module_t *module = NULL;
+  error = wasmtime_module_new(engine, (uint8_t*) wasm.data, wasm.size, &module);
+  if (module == NULL)
+    exit_with_error("failed to compile module", error, NULL);
+  wasm_byte_vec_delete(&wasm);
+
+  // Define `host.sleep` and instantiate through the async linker
+  wasmtime_linker_t *linker = wasmtime_linker_new(engine);
+  wasm_functype_t *sleep_ty = wasm_functype_new_1_1(wasm_valtype_new_i32(), wasm_valtype_new_i32());
+  error = wasmtime_linker_define_async_func(linker, "host", 4, "sleep", 5, sleep_ty,
+                                            sleep_callback, NULL, NULL);
+  wasm_functype_delete(sleep_ty);
+  if (error != NULL)
+    exit_with_error("failed to define host.sleep", error, NULL);
+
+  wasmtime_instance_t instance;
+  run_to_completion(wasmtime_linker_instantiate_async(linker, context, module, &instance,
+                                                      &trap, &error));
+  if (error != NULL || trap != NULL)
+    exit_with_error("failed to instantiate", error, trap);
+
+  wasmtime_extern_t sleep, spin;
+  bool ok = wasmtime_instance_export_get(context, &instance, "sleep", strlen("sleep"), &sleep);
+  assert(ok && sleep.kind == WASMTIME_EXTERN_FUNC);
+  ok = wasmtime_instance_export_get(context, &instance, "spin", strlen("spin"), &spin);
+  assert(ok && spin.kind == WASMTIME_EXTERN_FUNC);
+
+  // The host yields while it "sleeps", so the call takes several polls.
+  wasmtime_val_t args[1], results[1];
+  args[0].kind = WASMTIME_I32;
+  args[0].of.i32 = 3;
+  int polls = call(context, &sleep.of.func, args, 1, results, 1, &trap);
+  if (trap != NULL)
+    exit_with_error("sleep trapped", NULL, trap);
+  assert(results[0].kind == WASMTIME_I32 && results[0].of.i32 == 4);
+  assert(polls > 3);
+  printf("sleep(3) = %d after %d polls\n", results[0].of.i32, polls);
+
+  // A trapping host function ends the call with a trap, and the store can be
+  // used again afterwards.
+  args[0].of.i32 = -1;
+  call(context, &sleep.of.func, args, 1, results, 1, &trap);
+  assert(trap != NULL);
+  wasm_trap_delete(trap);
+  printf("sleep(-1) trapped\n");
+
+  args[0].of.i32 = 1;
+  call(context, &sleep.of.func, args, 1, results, 1, &trap);
+  if (trap != NULL)
+    exit_with_error("sleep trapped", NULL, trap);
+  assert(results[0].of.i32 == 2);
+
+  // The guest yields whenever it runs out of fuel.
+  args[0].of.i32 = 100000;
+  polls = call(context, &spin.of.func, args, 1, NULL, 0, &trap);
+  if (trap != NULL)
+    exit_with_error("spin trapped", NULL, trap);
+  assert(polls > 1);
+  printf("spin(100000) took %d polls\n", polls);
+
+  // Clean up after ourselves at this point
+  wasmtime_linker_delete(linker);
+  wasmtime_module_delete(module);
+  wasmtime_store_delete(store);
+  wasm_engine_delete(engine);
+  return 0;
+}
+
+static void exit_with_error(const char *message, wasmtime_error_t *error, wasm_trap_t *trap) {
+  fprintf(stderr, "error: %s\n", message);
+  wasm_byte_vec_t error_message;
+  if (error != NULL) {
+    wasmtime_error_message(error, &error_message);
+  } else {
+    wasm_trap_message(trap, &error_message);
+  }
+  fprintf(stderr, "%.*s\n", (int) error_message.size, error_message.data);
+  wasm_byte_vec_delete(&error_message);
+  exit(1);
+}
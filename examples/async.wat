@@ -0,0 +1,16 @@
+(module
+  (import "host" "sleep" (func $sleep (param i32) (result i32)))
+
+  ;; Hands `n` to the host, which takes `n` polls to answer with `n + 1`.
+  (func (export "sleep") (param $n i32) (result i32)
+    (call $sleep (local.get $n))
+  )
+
+  ;; Counts down from `n`, burning enough fuel to have to yield.
+  (func (export "spin") (param $n i32)
+    (loop $continue
+      (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+      (br_if $continue (local.get $n))
+    )
+  )
+)
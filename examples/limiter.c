@@ -0,0 +1,198 @@
+/*
+Example of restricting how much memory and table space a store may use, and
+of observing how much it has been granted.
+
+You can compile and run this example on Linux with:
+
+   cargo build --release -p wasmtime-c-api
+   cc examples/limiter.c \
+       -I crates/c-api/include \
+       -I crates/c-api/wasm-c-api/include \
+       target/release/libwasmtime.a \
+       -lpthread -ldl -lm \
+       -o limiter
+   ./limiter
+
+Note that on Windows and macOS the command will be similar, but you'll need
+to tweak the `-lpthread` and such annotations.
+
+You can also build using cmake:
+
+mkdir build && cd build && cmake .. && cmake --build . --target wasmtime-limiter
+*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wasm.h>
+#include <wasmtime.h>
+
+#define PAGE 65536
+
+static void exit_with_error(const char *message, wasmtime_error_t *error, wasm_trap_t *trap);
+
+// Whether the growth callbacks allow growth, and how often they were asked.
+typedef struct {
+  bool allow;
+  int memory_calls;
+  int table_calls;
+} veto_state;
+
+static bool memory_growing(void *env, size_t current, size_t desired) {
+  veto_state *state = env;
+  assert(desired > current);
+  state->memory_calls++;
+  return state->allow;
+}
+
+static bool table_growing(void *env, uint32_t current, uint32_t desired) {
+  veto_state *state = env;
+  assert(desired > current);
+  state->table_calls++;
+  return state->allow;
+}
+
+static bool grow_memory(wasmtime_context_t *context, wasmtime_memory_t *memory, uint64_t delta) {
+  uint64_t prev;
+  wasmtime_error_t *error = wasmtime_memory_grow(context, memory, delta, &prev);
+  if (error == NULL)
+    return true;
+  wasmtime_error_delete(error);
+  return false;
+}
+
+static bool grow_table(wasmtime_context_t *context, wasmtime_table_t *table, uint32_t delta) {
+  wasmtime_val_t init;
+  init.kind = WASMTIME_FUNCREF;
+  init.of.funcref.store_id = 0;
+  uint32_t prev;
+  wasmtime_error_t *error = wasmtime_table_grow(context, table, delta, &init, &prev);
+  if (error == NULL)
+    return true;
+  wasmtime_error_delete(error);
+  return false;
+}
+
+static void check_usage(wasmtime_context_t *context, size_t memory_bytes, uint64_t table_elements) {
+  wasmtime_store_limiter_usage_t usage;
+  wasmtime_context_limiter_usage(context, &usage);
+  assert(usage.memory_bytes == memory_bytes);
+  assert(usage.table_elements == table_elements);
+}
+
+int main() {
+  wasmtime_error_t *error = NULL;
+  wasm_trap_t *trap = NULL;
+
+  wasm_engine_t *engine = wasm_engine_new();
+  assert(engine != NULL);
+  wasmtime_store_t *store = wasmtime_store_new(engine, NULL, NULL);
+  assert(store != NULL);
+  wasmtime_context_t *context = wasmtime_store_context(store);
+
+  // Allow at most 3 pages of memory and 5 table elements.
+  wasmtime_store_limiter(store, 3 * PAGE, 5, -1, -1, -1);
+
+  // Load our input file to parse it next
+  FILE* file = fopen("examples/limiter.wat", "r");
+  if (!file) {
+    printf("> Error loading file!\n");
+    return 1;
+  }
+  fseek(file, 0L, SEEK_END);
+  size_t file_size = ftell(file);
+  fseek(file, 0L, SEEK_SET);
+  wasm_byte_vec_t wat;
+  wasm_byte_vec_new_uninitialized(&wat, file_size);
+  if (fread(wat.data, file_size, 1, file) != 1) {
+    printf("> Error loading module!\n");
+    return 1;
+  }
+  fclose(file);
+
+  wasm_byte_vec_t wasm;
+  error = wasmtime_wat2wasm(wat.data, wat.size, &wasm);
+  if (error != NULL)
+    exit_with_error("failed to parse wat", error, NULL);
+  wasm_byte_vec_delete(&wat);
+
+  wasmtime_module_t *module = NULL;
+  error = wasmtime_module_new(engine, (uint8_t*) wasm.data, wasm.size, &module);
+  if (module == NULL)
+    exit_with_error("failed to compile module", error, NULL);
+  wasm_byte_vec_delete(&wasm);
+
+  wasmtime_instance_t instance;
+  error = wasmtime_instance_new(context, module, NULL, 0, &instance, &trap);
+  if (error != NULL || trap != NULL)
+    exit_with_error("failed to instantiate", error, trap);
+
+  wasmtime_extern_t item;
+  bool ok = wasmtime_instance_export_get(context, &instance, "memory", strlen("memory"), &item);
+  assert(ok && item.kind == WASMTIME_EXTERN_MEMORY);
+  wasmtime_memory_t memory = item.of.memory;
+  ok = wasmtime_instance_export_get(context, &instance, "table", strlen("table"), &item);
+  assert(ok && item.kind == WASMTIME_EXTERN_TABLE);
+  wasmtime_table_t table = item.of.table;
+
+  // Creating the memory and table counts towards the usage.
+  check_usage(context, PAGE, 1);
+
+  // Growth within the static limits succeeds, growth beyond them fails and
+  // isn't counted.
+  printf("Growing within and beyond the static limits...\n");
+  assert(grow_memory(context, &memory, 1));
+  assert(!grow_memory(context, &memory, 2));
+  assert(grow_table(context, &table, 4));
+  assert(!grow_table(context, &table, 1));
+  check_usage(context, 2 * PAGE, 5);
+
+  // Lift the static limits and let the callbacks decide instead.
+  wasmtime_store_limiter(store, -1, -1, -1, -1, -1);
+  veto_state veto = { false, 0, 0 };
+  wasmtime_store_limiter_callbacks(store, memory_growing, table_growing, &veto, NULL);
+
+  printf("Vetoing growth from the callbacks...\n");
+  assert(!grow_memory(context, &memory, 1));
+  assert(!grow_table(context, &table, 1));
+  assert(veto.memory_calls == 1 && veto.table_calls == 1);
+  check_usage(context, 2 * PAGE, 5);
+
+  // Growth the limiter grants can still fail past the maximum declared by the
+  // module, and is then taken back out of the counters.
+  printf("Failing growth the limiter granted...\n");
+  veto.allow = true;
+  assert(!grow_memory(context, &memory, 3));
+  assert(!grow_table(context, &table, 6));
+  assert(veto.memory_calls == 2 && veto.table_calls == 2);
+  check_usage(context, 2 * PAGE, 5);
+
+  assert(grow_memory(context, &memory, 2));
+  assert(grow_table(context, &table, 5));
+  check_usage(context, 4 * PAGE, 10);
+
+  wasmtime_store_limiter_usage_t usage;
+  wasmtime_context_limiter_usage(context, &usage);
+  printf("Granted %zu bytes of memory and %llu table elements\n",
+         usage.memory_bytes, (unsigned long long) usage.table_elements);
+
+  // Clean up after ourselves at this point
+  wasmtime_module_delete(module);
+  wasmtime_store_delete(store);
+  wasm_engine_delete(engine);
+  return 0;
+}
+
+static void exit_with_error(const char *message, wasmtime_error_t *error, wasm_trap_t *trap) {
+  fprintf(stderr, "error: %s\n", message);
+  wasm_byte_vec_t error_message;
+  if (error != NULL) {
+    wasmtime_error_message(error, &error_message);
+  } else {
+    wasm_trap_message(trap, &error_message);
+  }
+  fprintf(stderr, "%.*s\n", (int) error_message.size, error_message.data);
+  wasm_byte_vec_delete(&error_message);
+  exit(1);
+}
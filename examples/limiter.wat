@@ -0,0 +1,4 @@
+(module
+  (memory (export "memory") 1 4)
+  (table (export "table") 1 10 funcref)
+)
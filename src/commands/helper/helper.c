@@ -8,11 +8,18 @@ void get_linear_memory(char *mem) {
 }
 
 void* transfer_i32_to_ptr(int i32) {
+    if (bridge_provenance_enabled())
+        bridge_provenance_from_guest(i32);
     return linear_memory + i32;
 }
 
 int transfer_ptr_to_i32(void *ptr) {
     char *cast_ptr = ptr;
+    // A NULL host pointer is the guest's NULL, not an address to translate.
+    if (!ptr)
+        return 0;
+    if (bridge_provenance_enabled())
+        bridge_provenance_to_guest(ptr);
     return (cast_ptr - linear_memory) / sizeof(char);
 }
 
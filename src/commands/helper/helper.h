@@ -1,6 +1,7 @@
 #ifndef HELPER_H
 #define HELPER_H
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -38,4 +39,133 @@ void my_free(void* ptr);
 
 // == func pointer == //
 
+// == bridge == //
+typedef void (*bridge_native)(void);
+
+typedef struct {
+    const char *name;
+    bridge_native native;
+} bridge_symbol;
+
+// Looks up a bridged native by symbol name, NULL if it isn't linked in.
+bridge_native bridge_resolve(const char *name);
+// Index of a bridged native in the symbol table, -1 if it isn't linked in.
+int bridge_symbol_index(const char *name);
+int bridge_symbol_count(void);
+const char* bridge_symbol_name(int index);
+
+// == bridge stats == //
+#define BRIDGE_STATS_BUCKETS 32
+
+typedef struct {
+    uint64_t calls;
+    uint64_t marshal_ns;
+    uint64_t native_ns;
+    uint64_t bytes;
+    // Bucket i counts calls whose total latency was below 2^(i+1) ns.
+    uint64_t latency[BRIDGE_STATS_BUCKETS];
+} bridge_stats;
+
+// Counting is off until enabled, every other call is a no-op until then.
+void bridge_stats_enable(int on);
+int bridge_stats_enabled(void);
+// Marks `index` as the import running on this thread, so natives can
+// attribute translated bytes to it with BRIDGE_STATS_BYTES.
+void bridge_stats_enter(int index);
+void bridge_stats_record(int index, uint64_t marshal_ns, uint64_t native_ns);
+void bridge_stats_add_bytes(uint64_t bytes);
+// Monotonic nanoseconds, 0 while counting is off.
+uint64_t bridge_stats_now(void);
+// Moves the time since `start` from the native time of the running import to
+// its marshal time, once bridge_stats_record is called for it.
+void bridge_stats_add_marshal(uint64_t start);
+// Sums the counters of every thread that called `index` so far.
+void bridge_stats_snapshot(int index, bridge_stats *out);
+
+#define BRIDGE_STATS_BYTES(n) bridge_stats_add_bytes(n)
+// Brackets the translation work a native does between guest and host
+// records, so it is counted as marshalling rather than native time.
+#define BRIDGE_STATS_MARSHAL_BEGIN(t) uint64_t t = bridge_stats_now()
+#define BRIDGE_STATS_MARSHAL_END(t) bridge_stats_add_marshal(t)
+
+// == bridge provenance == //
+#define BRIDGE_PROVENANCE_OFF 0
+// Print every violation to stderr and carry on.
+#define BRIDGE_PROVENANCE_REPORT 1
+// Print the first violation to stderr and abort.
+#define BRIDGE_PROVENANCE_ABORT 2
+
+void bridge_provenance_enable(int mode);
+int bridge_provenance_enabled(void);
+unsigned long bridge_provenance_violations(void);
+// Hooks for the transfer_* functions, only called while enabled.
+void bridge_provenance_from_guest(int i32);
+void bridge_provenance_to_guest(const void *ptr);
+// Stores `value` into a guest pointer field, first checking that it came out
+// of a translation rather than being a host pointer or some other integer.
+// `field` needn't be aligned. Every write-back of a translated pointer into
+// guest memory goes through here, including bridge_layout_to_guest.
+void bridge_store_guest_ptr(void *field, int value);
+
+#define GUEST_PTR_STORE(field, value) bridge_store_guest_ptr(&(field), (value))
+
+// == bridge layout == //
+// Bytes copied as is.
+#define BRIDGE_FIELD_SCALAR 0
+// A 32-bit offset in the guest record, a host pointer in the host record.
+#define BRIDGE_FIELD_PTR 1
+
+#define BRIDGE_LAYOUT_MAX_FIELDS 16
+
+typedef struct {
+    int kind;
+    uint32_t guest_offset;
+    uint32_t host_offset;
+    // Ignored for BRIDGE_FIELD_PTR.
+    uint32_t size;
+} bridge_field;
+
+typedef struct bridge_layout bridge_layout;
+typedef void (*bridge_convert)(const bridge_layout *plan, char *dst, const char *src, size_t n);
+
+// Precomputed conversion between a guest record (e.g. WasmStu) and its host
+// counterpart (e.g. Stu), built once per struct by bridge_layout_init.
+struct bridge_layout {
+    uint32_t guest_size;
+    uint32_t host_size;
+    uint32_t nptrs;
+    uint32_t nruns;
+    uint32_t ptr_guest[BRIDGE_LAYOUT_MAX_FIELDS];
+    uint32_t ptr_host[BRIDGE_LAYOUT_MAX_FIELDS];
+    // Adjacent scalar fields merged into single copies.
+    bridge_field runs[BRIDGE_LAYOUT_MAX_FIELDS];
+    // Both records are the same bytes, so conversion is a plain memcpy.
+    int identity;
+    // AVX2, SSE4.1 or scalar, picked for this CPU at init.
+    bridge_convert to_host;
+    bridge_convert to_guest;
+};
+
+// Returns -1 if there are too many fields, one has an unknown kind or one
+// doesn't fit its record.
+int bridge_layout_init(bridge_layout *plan, const bridge_field *fields, int nfields,
+                       uint32_t guest_size, uint32_t host_size);
+// Converts `n` consecutive records, pointer fields are translated the same
+// way as transfer_i32_to_ptr and transfer_ptr_to_i32. While provenance
+// tracking is on, both directions take the scalar path so that each offset
+// brought in is tagged and each pointer stored back is checked by
+// GUEST_PTR_STORE.
+void bridge_layout_to_host(const bridge_layout *plan, void *host, const void *guest, size_t n);
+void bridge_layout_to_guest(const bridge_layout *plan, void *guest, const void *host, size_t n);
+
+// Struct results come back through a hidden guest pointer `ret`. A native
+// builds its result in the slot returned here, which is the guest record
+// itself when the plan is an identity and a per-thread host-layout scratch
+// otherwise, then commits it to convert the scratch straight into `ret`. The
+// scratch is freed when its thread exits.
+// The slot is NULL if the scratch can't be allocated, and the native must then
+// fail the call without committing.
+void* bridge_result_slot(const bridge_layout *plan, int ret);
+void bridge_result_commit(const bridge_layout *plan, int ret, void *slot);
+
 #endif // HELPER_H
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include <string.h>
+
+#include "helper.h"
+
+void modify_fp(int fp);
+int modify(int op, int md_name);
+void check_struct(int c);
+int new_stu(int ret, int name, int age);
+
+// Natives the bridge can bind imports to. Keep this sorted by name, it is
+// binary searched when an import is called for the first time.
+static const bridge_symbol bridge_symbols[] = {
+    { "check_struct", (bridge_native)check_struct },
+    { "modify", (bridge_native)modify },
+    { "modify_fp", (bridge_native)modify_fp },
+    { "new_stu", (bridge_native)new_stu },
+};
+
+static int bridge_symbol_cmp(const void *name, const void *sym) {
+    return strcmp(name, ((const bridge_symbol *)sym)->name);
+}
+
+#define BRIDGE_SYMBOL_COUNT (sizeof(bridge_symbols) / sizeof(bridge_symbols[0]))
+
+static const bridge_symbol* bridge_lookup(const char *name) {
+    return bsearch(name, bridge_symbols, BRIDGE_SYMBOL_COUNT,
+        sizeof(bridge_symbol), bridge_symbol_cmp);
+}
+
+bridge_native bridge_resolve(const char *name) {
+    const bridge_symbol *sym = bridge_lookup(name);
+    return sym ? sym->native : NULL;
+}
+
+int bridge_symbol_index(const char *name) {
+    const bridge_symbol *sym = bridge_lookup(name);
+    return sym ? (int)(sym - bridge_symbols) : -1;
+}
+
+int bridge_symbol_count(void) {
+    return BRIDGE_SYMBOL_COUNT;
+}
+
+const char* bridge_symbol_name(int index) {
+    if (index < 0 || index >= (int)BRIDGE_SYMBOL_COUNT)
+        return NULL;
+    return bridge_symbols[index].name;
+}
@@ -47,11 +47,15 @@ void register_modify_name(modify_get_name func, void* closure) {
 }
 
 int modify(int op, int md_name) {
+    BRIDGE_STATS_MARSHAL_BEGIN(marshal);
     WasmModify *md = transfer_i32_to_ptr(op);
+    BRIDGE_STATS_BYTES(sizeof(WasmModify));
     WasmFuncPointer fp = md->fp;
     WasmState ws = md->s;
-    ma(fp.modfify_age, transfer_ptr_to_i32(&md->s), 31, modify_age_closure);
-    int ret_name = mn(fp.modify_get_name, transfer_ptr_to_i32(&md->s), md_name, modify_name_closure);
+    int state = transfer_ptr_to_i32(&md->s);
+    BRIDGE_STATS_MARSHAL_END(marshal);
+    ma(fp.modfify_age, state, 31, modify_age_closure);
+    int ret_name = mn(fp.modify_get_name, state, md_name, modify_name_closure);
     return ret_name;
 }
 
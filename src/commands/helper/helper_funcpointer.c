@@ -11,14 +11,19 @@ typedef struct {
 } MyFuncPointer;
 
 void modify_fp(int fp) {
+    BRIDGE_STATS_MARSHAL_BEGIN(to_host);
     MyFuncPointer *p = transfer_i32_to_ptr(fp);
+    BRIDGE_STATS_BYTES(sizeof(MyFuncPointer));
     //printf("%d\n", p->name);
     char *name = transfer_i32_to_ptr(p->name);
+    BRIDGE_STATS_MARSHAL_END(to_host);
     //printf("host name: %s\n", name);
     char *new_name = malloc(sizeof(char) * 4);
     new_name[0] = 'T';
     new_name[1] = 'i';
     new_name[2] = 'm';
+    BRIDGE_STATS_MARSHAL_BEGIN(to_guest);
     int new_name_offset = transfer_ptr_to_i32(new_name);
-    p->name = new_name_offset;
+    GUEST_PTR_STORE(p->name, new_name_offset);
+    BRIDGE_STATS_MARSHAL_END(to_guest);
 }
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include <pthread.h>
+#include <string.h>
+
+#include "helper.h"
+
+#if defined(CFG_TARGET_ARCH_x86_64)
+#include <immintrin.h>
+#endif
+
+// == scalar == //
+
+// Most runs are a single int or pointer-sized field, give the compiler a
+// constant size for those so the copy becomes one load and store.
+static inline void copy_run(char *dst, const char *src, uint32_t size) {
+    switch (size) {
+    case 4: memcpy(dst, src, 4); break;
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    default: memcpy(dst, src, size); break;
+    }
+}
+
+static void record_to_host(const bridge_layout *plan, char *h, const char *g) {
+    for (uint32_t r = 0; r < plan->nruns; r++)
+        copy_run(h + plan->runs[r].host_offset, g + plan->runs[r].guest_offset, plan->runs[r].size);
+    for (uint32_t k = 0; k < plan->nptrs; k++) {
+        int off;
+        memcpy(&off, g + plan->ptr_guest[k], sizeof(off));
+        char *p = transfer_i32_to_ptr(off);
+        memcpy(h + plan->ptr_host[k], &p, sizeof(p));
+    }
+}
+
+static void record_to_guest(const bridge_layout *plan, char *g, const char *h) {
+    for (uint32_t r = 0; r < plan->nruns; r++)
+        copy_run(g + plan->runs[r].guest_offset, h + plan->runs[r].host_offset, plan->runs[r].size);
+    for (uint32_t k = 0; k < plan->nptrs; k++) {
+        char *p;
+        memcpy(&p, h + plan->ptr_host[k], sizeof(p));
+        GUEST_PTR_STORE(g[plan->ptr_guest[k]], transfer_ptr_to_i32(p));
+    }
+}
+
+static void to_host_scalar(const bridge_layout *plan, char *host, const char *guest, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        record_to_host(plan, host + i * plan->host_size, guest + i * plan->guest_size);
+}
+
+static void to_guest_scalar(const bridge_layout *plan, char *guest, const char *host, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        record_to_guest(plan, guest + i * plan->guest_size, host + i * plan->host_size);
+}
+
+#if defined(CFG_TARGET_ARCH_x86_64)
+// The vector paths widen or narrow the pointer fields of several records at
+// once with strided loads. Scalar runs are copied a run at a time across the
+// whole block, so each run's offsets and size stay in registers, and whatever
+// doesn't fill a whole block goes through the scalar path.
+
+static void copy_runs_to_host(const bridge_layout *plan, char *h, const char *g, size_t n) {
+    const size_t gs = plan->guest_size, hs = plan->host_size;
+    for (uint32_t r = 0; r < plan->nruns; r++) {
+        const bridge_field run = plan->runs[r];
+        for (size_t i = 0; i < n; i++)
+            copy_run(h + i * hs + run.host_offset, g + i * gs + run.guest_offset, run.size);
+    }
+}
+
+static void copy_runs_to_guest(const bridge_layout *plan, char *g, const char *h, size_t n) {
+    const size_t gs = plan->guest_size, hs = plan->host_size;
+    for (uint32_t r = 0; r < plan->nruns; r++) {
+        const bridge_field run = plan->runs[r];
+        for (size_t i = 0; i < n; i++)
+            copy_run(g + i * gs + run.guest_offset, h + i * hs + run.host_offset, run.size);
+    }
+}
+
+// Stores the two pointers in `v` into the same field of consecutive records.
+static inline void store_ptr_pair(char *dst, size_t hs, __m128i v) {
+    _mm_storel_epi64((__m128i *)dst, v);
+    _mm_storeh_pd((double *)(dst + hs), _mm_castsi128_pd(v));
+}
+
+__attribute__((target("avx2")))
+static void to_host_avx2(const bridge_layout *plan, char *host, const char *guest, size_t n) {
+    const size_t gs = plan->guest_size, hs = plan->host_size;
+    const __m128i idx = _mm_setr_epi32(0, (int)gs, (int)(2 * gs), (int)(3 * gs));
+    const __m256i base = _mm256_set1_epi64x((long long)(uintptr_t)linear_memory);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        char *h = host + i * hs;
+        const char *g = guest + i * gs;
+        copy_runs_to_host(plan, h, g, 4);
+        for (uint32_t k = 0; k < plan->nptrs; k++) {
+            __m128i off = _mm_i32gather_epi32((const int *)(g + plan->ptr_guest[k]), idx, 1);
+            __m256i p = _mm256_add_epi64(_mm256_cvtepu32_epi64(off), base);
+            char *dst = h + plan->ptr_host[k];
+            store_ptr_pair(dst, hs, _mm256_castsi256_si128(p));
+            store_ptr_pair(dst + 2 * hs, hs, _mm256_extracti128_si256(p, 1));
+        }
+    }
+    to_host_scalar(plan, host + i * hs, guest + i * gs, n - i);
+}
+
+__attribute__((target("avx2")))
+static void to_guest_avx2(const bridge_layout *plan, char *guest, const char *host, size_t n) {
+    const size_t gs = plan->guest_size, hs = plan->host_size;
+    const __m128i idx = _mm_setr_epi32(0, (int)hs, (int)(2 * hs), (int)(3 * hs));
+    const __m256i base = _mm256_set1_epi64x((long long)(uintptr_t)linear_memory);
+    const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        char *g = guest + i * gs;
+        const char *h = host + i * hs;
+        copy_runs_to_guest(plan, g, h, 4);
+        for (uint32_t k = 0; k < plan->nptrs; k++) {
+            __m256i p = _mm256_i32gather_epi64((const long long *)(h + plan->ptr_host[k]), idx, 1);
+            // NULL stays the guest's NULL rather than becoming -base.
+            __m256i is_null = _mm256_cmpeq_epi64(p, _mm256_setzero_si256());
+            __m256i off = _mm256_permutevar8x32_epi32(
+                _mm256_andnot_si256(is_null, _mm256_sub_epi64(p, base)), low_halves);
+            __m128i o = _mm256_castsi256_si128(off);
+            char *dst = g + plan->ptr_guest[k];
+            uint32_t o0 = _mm_extract_epi32(o, 0), o1 = _mm_extract_epi32(o, 1);
+            uint32_t o2 = _mm_extract_epi32(o, 2), o3 = _mm_extract_epi32(o, 3);
+            memcpy(dst, &o0, 4);
+            memcpy(dst + gs, &o1, 4);
+            memcpy(dst + 2 * gs, &o2, 4);
+            memcpy(dst + 3 * gs, &o3, 4);
+        }
+    }
+    to_guest_scalar(plan, guest + i * gs, host + i * hs, n - i);
+}
+
+__attribute__((target("sse4.1")))
+static void to_host_sse41(const bridge_layout *plan, char *host, const char *guest, size_t n) {
+    const size_t gs = plan->guest_size, hs = plan->host_size;
+    const __m128i base = _mm_set1_epi64x((long long)(uintptr_t)linear_memory);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        char *h = host + i * hs;
+        const char *g = guest + i * gs;
+        copy_runs_to_host(plan, h, g, 2);
+        for (uint32_t k = 0; k < plan->nptrs; k++) {
+            uint32_t o0, o1;
+            memcpy(&o0, g + plan->ptr_guest[k], 4);
+            memcpy(&o1, g + gs + plan->ptr_guest[k], 4);
+            __m128i p = _mm_add_epi64(_mm_cvtepu32_epi64(_mm_setr_epi32((int)o0, (int)o1, 0, 0)), base);
+            store_ptr_pair(h + plan->ptr_host[k], hs, p);
+        }
+    }
+    to_host_scalar(plan, host + i * hs, guest + i * gs, n - i);
+}
+
+__attribute__((target("sse4.1")))
+static void to_guest_sse41(const bridge_layout *plan, char *guest, const char *host, size_t n) {
+    const size_t gs = plan->guest_size, hs = plan->host_size;
+    const __m128i base = _mm_set1_epi64x((long long)(uintptr_t)linear_memory);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        char *g = guest + i * gs;
+        const char *h = host + i * hs;
+        copy_runs_to_guest(plan, g, h, 2);
+        for (uint32_t k = 0; k < plan->nptrs; k++) {
+            __m128i p = _mm_castpd_si128(_mm_loadh_pd(
+                _mm_castsi128_pd(_mm_loadl_epi64((const __m128i *)(h + plan->ptr_host[k]))),
+                (const double *)(h + hs + plan->ptr_host[k])));
+            __m128i is_null = _mm_cmpeq_epi64(p, _mm_setzero_si128());
+            __m128i off = _mm_andnot_si128(is_null, _mm_sub_epi64(p, base));
+            uint32_t o0 = _mm_extract_epi32(off, 0), o1 = _mm_extract_epi32(off, 2);
+            memcpy(g + plan->ptr_guest[k], &o0, 4);
+            memcpy(g + gs + plan->ptr_guest[k], &o1, 4);
+        }
+    }
+    to_guest_scalar(plan, guest + i * gs, host + i * hs, n - i);
+}
+#endif
+
+static void copy_identity(const bridge_layout *plan, char *dst, const char *src, size_t n) {
+    memcpy(dst, src, n * plan->host_size);
+}
+
+// == plan == //
+
+static int field_cmp(const void *a, const void *b) {
+    const bridge_field *fa = a, *fb = b;
+    return (fa->host_offset > fb->host_offset) - (fa->host_offset < fb->host_offset);
+}
+
+int bridge_layout_init(bridge_layout *plan, const bridge_field *fields, int nfields,
+                       uint32_t guest_size, uint32_t host_size) {
+    bridge_field sorted[BRIDGE_LAYOUT_MAX_FIELDS];
+    if (nfields < 0 || nfields > BRIDGE_LAYOUT_MAX_FIELDS)
+        return -1;
+    memcpy(sorted, fields, nfields * sizeof(bridge_field));
+    qsort(sorted, nfields, sizeof(bridge_field), field_cmp);
+
+    memset(plan, 0, sizeof(*plan));
+    plan->guest_size = guest_size;
+    plan->host_size = host_size;
+    for (int f = 0; f < nfields; f++) {
+        const bridge_field *field = &sorted[f];
+        if (field->kind != BRIDGE_FIELD_SCALAR && field->kind != BRIDGE_FIELD_PTR)
+            return -1;
+        if (field->kind == BRIDGE_FIELD_PTR) {
+            // Written as `offset > size - width` so that a huge offset can't
+            // wrap around and pass.
+            if (guest_size < 4 || field->guest_offset > guest_size - 4
+                    || host_size < sizeof(void *) || field->host_offset > host_size - sizeof(void *))
+                return -1;
+            plan->ptr_guest[plan->nptrs] = field->guest_offset;
+            plan->ptr_host[plan->nptrs] = field->host_offset;
+            plan->nptrs++;
+            continue;
+        }
+        if (field->size > guest_size || field->guest_offset > guest_size - field->size
+                || field->size > host_size || field->host_offset > host_size - field->size)
+            return -1;
+        // Scalars that sit back to back on both sides are copied as one run.
+        bridge_field *last = plan->nruns ? &plan->runs[plan->nruns - 1] : NULL;
+        if (last && last->guest_offset + last->size == field->guest_offset
+                 && last->host_offset + last->size == field->host_offset) {
+            last->size += field->size;
+            continue;
+        }
+        plan->runs[plan->nruns++] = *field;
+    }
+
+    plan->identity = plan->nptrs == 0 && guest_size == host_size
+        && (guest_size == 0 || (plan->nruns == 1 && plan->runs[0].guest_offset == 0
+            && plan->runs[0].host_offset == 0 && plan->runs[0].size == guest_size));
+    if (plan->identity) {
+        plan->to_host = copy_identity;
+        plan->to_guest = copy_identity;
+        return 0;
+    }
+
+    plan->to_host = to_host_scalar;
+    plan->to_guest = to_guest_scalar;
+#if defined(CFG_TARGET_ARCH_x86_64)
+    // Vector strides are gather indices, keep 3 records' worth within an int.
+    if (plan->nptrs > 0 && guest_size < (1u << 28) && host_size < (1u << 28)) {
+        if (__builtin_cpu_supports("avx2")) {
+            plan->to_host = to_host_avx2;
+            plan->to_guest = to_guest_avx2;
+        } else if (__builtin_cpu_supports("sse4.1")) {
+            plan->to_host = to_host_sse41;
+            plan->to_guest = to_guest_sse41;
+        }
+    }
+#endif
+    return 0;
+}
+
+void bridge_layout_to_host(const bridge_layout *plan, void *host, const void *guest, size_t n) {
+    // The vector paths widen offsets without tagging them as guest pointers.
+    if (plan->nptrs > 0 && bridge_provenance_enabled()) {
+        to_host_scalar(plan, host, guest, n);
+        return;
+    }
+    plan->to_host(plan, host, guest, n);
+}
+
+void bridge_layout_to_guest(const bridge_layout *plan, void *guest, const void *host, size_t n) {
+    // The vector paths narrow pointers without going through GUEST_PTR_STORE.
+    if (plan->nptrs > 0 && bridge_provenance_enabled()) {
+        to_guest_scalar(plan, guest, host, n);
+        return;
+    }
+    plan->to_guest(plan, guest, host, n);
+}
+
+// == results == //
+
+// Host-layout scratch for struct results, reused by every call on a thread.
+// It's also registered under result_scratch_key so that it's freed when the
+// thread exits.
+static _Thread_local char *result_scratch;
+static _Thread_local size_t result_scratch_size;
+static pthread_key_t result_scratch_key;
+static pthread_once_t result_scratch_once = PTHREAD_ONCE_INIT;
+static int result_scratch_key_ok;
+
+static void free_result_scratch(void *scratch) {
+    (free)(scratch);
+}
+
+static void init_result_scratch_key(void) {
+    result_scratch_key_ok = pthread_key_create(&result_scratch_key, free_result_scratch) == 0;
+}
+
+void* bridge_result_slot(const bridge_layout *plan, int ret) {
+    if (plan->identity)
+        return transfer_i32_to_ptr(ret);
+    if (result_scratch_size < plan->host_size) {
+        // Not the guest realloc helper.h redirects realloc to.
+        char *grown = (realloc)(result_scratch, plan->host_size);
+        if (!grown)
+            return NULL;
+        result_scratch = grown;
+        result_scratch_size = plan->host_size;
+        pthread_once(&result_scratch_once, init_result_scratch_key);
+        if (result_scratch_key_ok)
+            pthread_setspecific(result_scratch_key, grown);
+    }
+    return result_scratch;
+}
+
+void bridge_result_commit(const bridge_layout *plan, int ret, void *slot) {
+    if (plan->identity)
+        return;
+    bridge_layout_to_guest(plan, transfer_i32_to_ptr(ret), slot, 1);
+}
@@ -0,0 +1,101 @@
+#include <stdatomic.h>
+#include <string.h>
+
+#include "helper.h"
+
+// One bit per byte of a 64 KiB wasm page, set once an offset into that page
+// has been handed across the bridge by transfer_i32_to_ptr or produced by
+// transfer_ptr_to_i32. Bits are never cleared, so an offset that was valid
+// once and freed since still passes; the goal is catching raw host pointers.
+#define SHADOW_PAGE_SHIFT 16
+#define SHADOW_PAGE_COUNT (1 << 16)
+#define SHADOW_PAGE_WORDS ((1 << SHADOW_PAGE_SHIFT) / 64)
+
+// A wasm32 offset never reaches past 4 GiB from the base.
+#define LINEAR_MEMORY_WINDOW ((uint64_t)1 << 32)
+
+static atomic_int provenance_mode;
+static atomic_ulong provenance_violations;
+static _Atomic(_Atomic uint64_t *) *shadow_pages;
+
+static _Atomic uint64_t* shadow_page(uint32_t offset, int create) {
+    _Atomic(_Atomic uint64_t *) *slot = &shadow_pages[offset >> SHADOW_PAGE_SHIFT];
+    _Atomic uint64_t *page = atomic_load_explicit(slot, memory_order_acquire);
+    if (page || !create)
+        return page;
+    // calloc on purpose: malloc is redirected into guest memory by helper.h.
+    _Atomic uint64_t *fresh = calloc(SHADOW_PAGE_WORDS, sizeof(uint64_t));
+    if (!fresh)
+        return NULL;
+    if (!atomic_compare_exchange_strong_explicit(slot, &page, fresh,
+            memory_order_acq_rel, memory_order_acquire)) {
+        (free)(fresh);
+        return page;
+    }
+    return fresh;
+}
+
+static void provenance_tag(uint32_t offset) {
+    _Atomic uint64_t *page = shadow_page(offset, 1);
+    if (!page)
+        return;
+    _Atomic uint64_t *word = &page[(offset & 0xffff) >> 6];
+    uint64_t bit = (uint64_t)1 << (offset & 63);
+    // Most offsets are tagged already, skip the locked RMW for those.
+    if (!(atomic_load_explicit(word, memory_order_relaxed) & bit))
+        atomic_fetch_or_explicit(word, bit, memory_order_relaxed);
+}
+
+static int provenance_tagged(uint32_t offset) {
+    _Atomic uint64_t *page = shadow_page(offset, 0);
+    if (!page)
+        return 0;
+    uint64_t word = atomic_load_explicit(&page[(offset & 0xffff) >> 6], memory_order_relaxed);
+    return (word >> (offset & 63)) & 1;
+}
+
+static void provenance_violation(const char *what, uint64_t at, uint64_t value) {
+    atomic_fetch_add_explicit(&provenance_violations, 1, memory_order_relaxed);
+    fprintf(stderr, "bridge provenance: %s (at %#llx, value %#llx)\n",
+        what, (unsigned long long)at, (unsigned long long)value);
+    if (atomic_load_explicit(&provenance_mode, memory_order_relaxed) == BRIDGE_PROVENANCE_ABORT)
+        abort();
+}
+
+void bridge_provenance_enable(int mode) {
+    if (mode != BRIDGE_PROVENANCE_OFF && !shadow_pages) {
+        shadow_pages = calloc(SHADOW_PAGE_COUNT, sizeof(*shadow_pages));
+        if (!shadow_pages)
+            mode = BRIDGE_PROVENANCE_OFF;
+    }
+    atomic_store_explicit(&provenance_mode, mode, memory_order_relaxed);
+}
+
+int bridge_provenance_enabled(void) {
+    return atomic_load_explicit(&provenance_mode, memory_order_relaxed) != BRIDGE_PROVENANCE_OFF;
+}
+
+unsigned long bridge_provenance_violations(void) {
+    return atomic_load_explicit(&provenance_violations, memory_order_relaxed);
+}
+
+void bridge_provenance_from_guest(int i32) {
+    provenance_tag((uint32_t)i32);
+}
+
+void bridge_provenance_to_guest(const void *ptr) {
+    const char *p = ptr;
+    if (p < linear_memory || (uint64_t)(p - linear_memory) >= LINEAR_MEMORY_WINDOW) {
+        provenance_violation("host pointer translated as a guest offset",
+            (uint64_t)(uintptr_t)p, (uint64_t)(uintptr_t)p);
+        return;
+    }
+    provenance_tag((uint32_t)(p - linear_memory));
+}
+
+void bridge_store_guest_ptr(void *field, int value) {
+    if (bridge_provenance_enabled() && value != 0 && !provenance_tagged((uint32_t)value))
+        provenance_violation("untranslated value stored into a guest pointer field",
+            (uint64_t)((char *)field - linear_memory), (uint32_t)value);
+    memcpy(field, &value, sizeof(value));
+}
@@ -0,0 +1,144 @@
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+#include "helper.h"
+
+// Counters for one thread. Only the owning thread writes them, so updates are
+// plain relaxed load/store pairs instead of locked read-modify-writes, and
+// readers summing across threads may just see a slightly stale value.
+typedef struct thread_stats {
+    struct thread_stats *next;
+    int current;
+    // Translation time reported by the running import through
+    // BRIDGE_STATS_MARSHAL_*, folded into its record when it returns.
+    uint64_t pending_marshal_ns;
+    _Atomic uint64_t *counters;
+} thread_stats;
+
+#define STATS_FIELDS (4 + BRIDGE_STATS_BUCKETS)
+#define STAT_CALLS 0
+#define STAT_MARSHAL_NS 1
+#define STAT_NATIVE_NS 2
+#define STAT_BYTES 3
+#define STAT_LATENCY 4
+
+static atomic_int stats_on;
+// Every thread's block, pushed on first use and never unlinked, so that a
+// snapshot still sees calls made by threads that have since exited.
+static _Atomic(thread_stats *) all_stats;
+static _Thread_local thread_stats *local_stats;
+
+static thread_stats* stats_for_thread(void) {
+    if (local_stats)
+        return local_stats;
+    // calloc on purpose: malloc is redirected into guest memory by helper.h.
+    thread_stats *ts = calloc(1, sizeof(thread_stats));
+    if (!ts)
+        return NULL;
+    ts->counters = calloc((size_t)bridge_symbol_count() * STATS_FIELDS, sizeof(uint64_t));
+    if (!ts->counters) {
+        (free)(ts);
+        return NULL;
+    }
+    ts->current = -1;
+    ts->next = atomic_load_explicit(&all_stats, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&all_stats, &ts->next, ts,
+            memory_order_release, memory_order_relaxed))
+        ;
+    local_stats = ts;
+    return ts;
+}
+
+static void stat_add(thread_stats *ts, int index, int field, uint64_t v) {
+    _Atomic uint64_t *c = &ts->counters[index * STATS_FIELDS + field];
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + v,
+        memory_order_relaxed);
+}
+
+static int latency_bucket(uint64_t ns) {
+    int bucket = 0;
+    while (ns > 1 && bucket < BRIDGE_STATS_BUCKETS - 1) {
+        ns >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void bridge_stats_enable(int on) {
+    atomic_store_explicit(&stats_on, on, memory_order_relaxed);
+}
+
+int bridge_stats_enabled(void) {
+    return atomic_load_explicit(&stats_on, memory_order_relaxed);
+}
+
+void bridge_stats_enter(int index) {
+    if (!bridge_stats_enabled() || index < 0)
+        return;
+    thread_stats *ts = stats_for_thread();
+    if (ts) {
+        ts->current = index;
+        ts->pending_marshal_ns = 0;
+    }
+}
+
+void bridge_stats_record(int index, uint64_t marshal_ns, uint64_t native_ns) {
+    if (!bridge_stats_enabled() || index < 0 || index >= bridge_symbol_count())
+        return;
+    thread_stats *ts = stats_for_thread();
+    if (!ts)
+        return;
+    // The caller only sees the native as a whole, so the translation it did
+    // internally is carved out of the native time here.
+    uint64_t moved = ts->pending_marshal_ns < native_ns ? ts->pending_marshal_ns : native_ns;
+    marshal_ns += moved;
+    native_ns -= moved;
+    ts->pending_marshal_ns = 0;
+    stat_add(ts, index, STAT_CALLS, 1);
+    stat_add(ts, index, STAT_MARSHAL_NS, marshal_ns);
+    stat_add(ts, index, STAT_NATIVE_NS, native_ns);
+    stat_add(ts, index, STAT_LATENCY + latency_bucket(marshal_ns + native_ns), 1);
+    ts->current = -1;
+}
+
+void bridge_stats_add_bytes(uint64_t bytes) {
+    if (!bridge_stats_enabled())
+        return;
+    thread_stats *ts = stats_for_thread();
+    if (ts && ts->current >= 0)
+        stat_add(ts, ts->current, STAT_BYTES, bytes);
+}
+
+uint64_t bridge_stats_now(void) {
+    if (!bridge_stats_enabled())
+        return 0;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+void bridge_stats_add_marshal(uint64_t start) {
+    if (start == 0)
+        return;
+    uint64_t end = bridge_stats_now();
+    thread_stats *ts = stats_for_thread();
+    if (ts && ts->current >= 0 && end > start)
+        ts->pending_marshal_ns += end - start;
+}
+
+void bridge_stats_snapshot(int index, bridge_stats *out) {
+    memset(out, 0, sizeof(*out));
+    if (index < 0 || index >= bridge_symbol_count())
+        return;
+    thread_stats *ts = atomic_load_explicit(&all_stats, memory_order_acquire);
+    for (; ts; ts = ts->next) {
+        _Atomic uint64_t *c = &ts->counters[index * STATS_FIELDS];
+        out->calls += atomic_load_explicit(&c[STAT_CALLS], memory_order_relaxed);
+        out->marshal_ns += atomic_load_explicit(&c[STAT_MARSHAL_NS], memory_order_relaxed);
+        out->native_ns += atomic_load_explicit(&c[STAT_NATIVE_NS], memory_order_relaxed);
+        out->bytes += atomic_load_explicit(&c[STAT_BYTES], memory_order_relaxed);
+        for (int i = 0; i < BRIDGE_STATS_BUCKETS; i++)
+            out->latency[i] += atomic_load_explicit(&c[STAT_LATENCY + i], memory_order_relaxed);
+    }
+}
@@ -1,3 +1,6 @@
+#include <pthread.h>
+#include <stddef.h>
+
 #include "helper.h"
 
 typedef struct {
@@ -21,11 +24,49 @@ typedef struct {
 } WasmClass;
 
 void check_struct(int c) {
+    BRIDGE_STATS_MARSHAL_BEGIN(marshal);
     WasmClass *wc = transfer_i32_to_ptr(c);
+    BRIDGE_STATS_BYTES(sizeof(WasmClass));
     //printf("st: %d\n", wc->st);
     WasmStu s = wc->st;
-    printf("s->name %s\n", transfer_i32_to_ptr(s.name));
+    char *s_name = transfer_i32_to_ptr(s.name);
     //printf("%s\n", transfer_i32_to_ptr(s->name));
     WasmStu *te = transfer_i32_to_ptr(c + 8);
-    printf("te: %s\n", transfer_i32_to_ptr(te->name));
-}
\ No newline at end of file
+    char *te_name = transfer_i32_to_ptr(te->name);
+    BRIDGE_STATS_MARSHAL_END(marshal);
+    printf("s->name %s\n", s_name);
+    printf("te: %s\n", te_name);
+}
+
+// == struct result == //
+static const bridge_field stu_fields[] = {
+    { BRIDGE_FIELD_PTR, offsetof(WasmStu, name), offsetof(Stu, name), 0 },
+    { BRIDGE_FIELD_SCALAR, offsetof(WasmStu, age), offsetof(Stu, age), sizeof(int) },
+};
+static bridge_layout stu_layout;
+static pthread_once_t stu_layout_once = PTHREAD_ONCE_INIT;
+
+static void init_stu_layout(void) {
+    bridge_layout_init(&stu_layout, stu_fields, sizeof(stu_fields) / sizeof(stu_fields[0]),
+        sizeof(WasmStu), sizeof(Stu));
+}
+
+// Stu new_stu(char *name, int age) on the guest side, lowered by wasm to
+// take the result pointer as its first parameter. Returns -1 when there is
+// no room for the result, which the caller turns into a trap.
+int new_stu(int ret, int name, int age) {
+    pthread_once(&stu_layout_once, init_stu_layout);
+    // Building the result is all translation, there is no native work.
+    BRIDGE_STATS_MARSHAL_BEGIN(marshal);
+    Stu *s = bridge_result_slot(&stu_layout, ret);
+    if (!s) {
+        BRIDGE_STATS_MARSHAL_END(marshal);
+        return -1;
+    }
+    s->name = transfer_i32_to_ptr(name);
+    s->age = age;
+    bridge_result_commit(&stu_layout, ret, s);
+    BRIDGE_STATS_MARSHAL_END(marshal);
+    BRIDGE_STATS_BYTES(sizeof(WasmStu));
+    return 0;
+}
@@ -2,13 +2,17 @@
 
 use anyhow::{anyhow, bail, Context as _, Result};
 use clap::Parser;
-use libc::c_void;
+use libc::{c_char, c_int, c_void};
 use once_cell::sync::Lazy;
 use std::any::Any;
+use std::ffi::CStr;
 use std::fs::File;
 use std::io::Read;
+use std::mem;
+use std::ptr;
+use std::sync::atomic::{AtomicI32, AtomicPtr, Ordering};
 use std::thread;
-use std::time::Duration;
+use std::time::{Duration, Instant};
 use std::{
     ffi::OsStr,
     path::{Component, Path, PathBuf},
@@ -149,6 +153,17 @@ pub struct RunCommand {
     )]
     wasm_timeout: Option<Duration>,
 
+    /// Count calls, marshalling time, native time and bytes translated for
+    /// each bridged native, and print them to stderr on exit
+    #[clap(long = "bridge-stats")]
+    bridge_stats: bool,
+
+    /// Check that every value bridged natives store into guest pointer
+    /// fields came from a translated guest offset, reporting violations to
+    /// stderr
+    #[clap(long = "bridge-provenance")]
+    bridge_provenance: bool,
+
     // NOTE: this must come last for trailing varargs
     /// The arguments to pass to the module
     #[clap(value_name = "ARGS")]
@@ -167,6 +182,13 @@ impl RunCommand {
         let engine = Engine::new(&config)?;
         let mut store = Store::new(&engine, Host::default());
 
+        if self.bridge_stats {
+            unsafe { bridge_stats_enable(1) };
+        }
+        if self.bridge_provenance {
+            unsafe { bridge_provenance_enable(BRIDGE_PROVENANCE_REPORT) };
+        }
+
         // If fuel has been configured, we want to add the configured
         // fuel amount to this store.
         if let Some(fuel) = self.common.fuel {
@@ -182,10 +204,6 @@ impl RunCommand {
         let mut linker = Linker::new(&engine);
         linker.allow_unknown_exports(self.allow_unknown_exports);
 
-        linker.func_wrap("env", "modify_fp", wrap_modify_fp)?;
-        linker.func_wrap("env", "modify", wrap_modify)?;
-        linker.func_wrap("env", "check_struct", wrap_check_struct)?;
-
         populate_with_wasi(
             &mut store,
             &mut linker,
@@ -201,6 +219,7 @@ impl RunCommand {
         for (name, path) in self.preloads.iter() {
             // Read the wasm module binary either as `*.wat` or a raw binary
             let module = self.load_module(&engine, path)?;
+            link_bridged_imports(&mut store, &mut linker, &module)?;
 
             // Add the module's functions to the linker.
             linker.module(&mut store, name, &module).context(format!(
@@ -211,10 +230,22 @@ impl RunCommand {
         }
 
         // Load the main wasm module.
-        match self
+        let result = self
             .load_main_module(&mut store, &mut linker)
-            .with_context(|| format!("failed to run main module `{}`", self.module.display()))
-        {
+            .with_context(|| format!("failed to run main module `{}`", self.module.display()));
+
+        // Dump before any of the `process::exit` paths below.
+        if self.bridge_stats {
+            dump_bridge_stats();
+        }
+        if self.bridge_provenance {
+            let violations = unsafe { bridge_provenance_violations() };
+            if violations > 0 {
+                eprintln!("bridge provenance: {} violation(s)", violations);
+            }
+        }
+
+        match result {
             Ok(()) => (),
             Err(e) => {
                 // If the program exited because of a non-zero exit status, print
@@ -323,7 +354,9 @@ impl RunCommand {
         // Read the wasm module binary either as `*.wat` or a raw binary.
         let module = self.load_module(linker.engine(), &self.module)?;
 
-        // linker.func_wrap("env", "modify_fp", wrap_modify_fp)?;
+        // Only the bridged natives this module imports get wrapped, and each
+        // of those resolves its native symbol lazily on first call.
+        link_bridged_imports(&mut *store, linker, &module)?;
 
         // let instance = linker.instantiate(&mut *store, &module)?;
 
@@ -643,6 +676,237 @@ extern "C" fn wasm_free(ptr: *mut c_void, ctx: *mut c_void) {
     }
 }
 
+// ==== lazy binding ==== //
+#[link(name = "my-helpers")]
+extern "C" {
+    fn bridge_resolve(name: *const c_char) -> *mut c_void;
+    fn bridge_symbol_index(name: *const c_char) -> c_int;
+}
+
+/// A bridged native whose symbol is looked up on its first call and then
+/// cached in `slot`, so later calls jump straight to it (PLT style). Only the
+/// symbol resolution is lazy: the Wasm-facing wrapper around it is still
+/// registered with the linker when the importing module is loaded.
+struct LazyNative {
+    /// Nul-terminated symbol name handed to `bridge_resolve`.
+    name: &'static str,
+    slot: AtomicPtr<c_void>,
+    /// Position in the helpers' symbol table, which keys `bridge_stats_*`.
+    index: AtomicI32,
+}
+
+impl LazyNative {
+    const fn new(name: &'static str) -> LazyNative {
+        LazyNative {
+            name,
+            slot: AtomicPtr::new(ptr::null_mut()),
+            index: AtomicI32::new(-1),
+        }
+    }
+
+    fn get(&self) -> *mut c_void {
+        let native = self.slot.load(Ordering::Acquire);
+        if !native.is_null() {
+            return native;
+        }
+        self.resolve()
+    }
+
+    fn index(&self) -> c_int {
+        self.get();
+        self.index.load(Ordering::Relaxed)
+    }
+
+    #[cold]
+    fn resolve(&self) -> *mut c_void {
+        let native = unsafe { bridge_resolve(self.name.as_ptr().cast()) };
+        if native.is_null() {
+            panic!(
+                "bridged native `{}` is not linked into this host",
+                self.name.trim_end_matches('\0')
+            );
+        }
+        // Racing threads resolve to the same symbol, so last store wins.
+        let index = unsafe { bridge_symbol_index(self.name.as_ptr().cast()) };
+        self.index.store(index, Ordering::Relaxed);
+        self.slot.store(native, Ordering::Release);
+        native
+    }
+}
+
+/// Natives the bridge can satisfy `env` imports with. Nothing here is wrapped
+/// into the linker until a module that imports it is loaded, at which point
+/// the wrapper is registered eagerly and only its native symbol is resolved
+/// lazily.
+const BRIDGED_IMPORTS: &[(&str, fn(&mut Linker<Host>) -> Result<()>)] = &[
+    ("check_struct", |linker| {
+        linker.func_wrap("env", "check_struct", wrap_check_struct)?;
+        Ok(())
+    }),
+    ("modify", |linker| {
+        linker.func_wrap("env", "modify", wrap_modify)?;
+        Ok(())
+    }),
+    ("modify_fp", |linker| {
+        linker.func_wrap("env", "modify_fp", wrap_modify_fp)?;
+        Ok(())
+    }),
+    ("new_stu", |linker| {
+        linker.func_wrap("env", "new_stu", wrap_new_stu)?;
+        Ok(())
+    }),
+];
+
+/// Wraps the bridged natives `module` imports from `env` that the linker
+/// doesn't already define.
+fn link_bridged_imports(
+    store: &mut Store<Host>,
+    linker: &mut Linker<Host>,
+    module: &Module,
+) -> Result<()> {
+    for import in module.imports() {
+        if import.module() != "env" {
+            continue;
+        }
+        let bind = match BRIDGED_IMPORTS
+            .iter()
+            .find(|(name, _)| *name == import.name())
+        {
+            Some((_, bind)) => bind,
+            None => continue,
+        };
+        if linker.get(&mut *store, "env", import.name()).is_none() {
+            bind(linker)?;
+        }
+    }
+    Ok(())
+}
+
+// ==== bridge stats ==== //
+#[repr(C)]
+#[derive(Default)]
+struct BridgeStats {
+    calls: u64,
+    marshal_ns: u64,
+    native_ns: u64,
+    bytes: u64,
+    /// `BRIDGE_STATS_BUCKETS` log2 buckets of marshal + native nanoseconds.
+    latency: [u64; 32],
+}
+
+#[link(name = "my-helpers")]
+extern "C" {
+    fn bridge_symbol_count() -> c_int;
+    fn bridge_symbol_name(index: c_int) -> *const c_char;
+    fn bridge_stats_enable(on: c_int);
+    fn bridge_stats_enabled() -> c_int;
+    fn bridge_stats_enter(index: c_int);
+    fn bridge_stats_record(index: c_int, marshal_ns: u64, native_ns: u64);
+    fn bridge_stats_snapshot(index: c_int, out: *mut BridgeStats);
+}
+
+/// Times one call through a bridged native while stats are enabled. Time up
+/// to `native` counts as marshalling, the rest as spent in the native, minus
+/// the translation the native itself reports with `BRIDGE_STATS_MARSHAL_*`,
+/// which `bridge_stats_record` moves over to marshalling.
+struct BridgeCall {
+    index: c_int,
+    start: Option<Instant>,
+    native: Option<Instant>,
+}
+
+impl BridgeCall {
+    fn enter(native: &LazyNative) -> BridgeCall {
+        if unsafe { bridge_stats_enabled() } == 0 {
+            return BridgeCall {
+                index: -1,
+                start: None,
+                native: None,
+            };
+        }
+        let start = Instant::now();
+        let index = native.index();
+        unsafe { bridge_stats_enter(index) };
+        BridgeCall {
+            index,
+            start: Some(start),
+            native: None,
+        }
+    }
+
+    fn native(&mut self) {
+        if self.start.is_some() {
+            self.native = Some(Instant::now());
+        }
+    }
+}
+
+impl Drop for BridgeCall {
+    fn drop(&mut self) {
+        let start = match self.start {
+            Some(start) => start,
+            None => return,
+        };
+        let end = Instant::now();
+        let native = self.native.unwrap_or(end);
+        unsafe {
+            bridge_stats_record(
+                self.index,
+                (native - start).as_nanos() as u64,
+                (end - native).as_nanos() as u64,
+            )
+        }
+    }
+}
+
+/// Upper bound of the latency bucket holding the `q` quantile of `stats`.
+fn latency_quantile(stats: &BridgeStats, q: f64) -> Duration {
+    let target = (stats.calls as f64 * q).ceil() as u64;
+    let mut seen = 0;
+    for (i, count) in stats.latency.iter().enumerate() {
+        seen += count;
+        if seen >= target {
+            return Duration::from_nanos(1 << (i + 1));
+        }
+    }
+    Duration::from_nanos(1 << stats.latency.len())
+}
+
+/// Prints the counters of every bridged native that was called at least once.
+fn dump_bridge_stats() {
+    eprintln!(
+        "{:<24} {:>10} {:>14} {:>14} {:>12} {:>12} {:>12}",
+        "bridged native", "calls", "marshal avg", "native avg", "bytes", "p50 <", "p99 <"
+    );
+    for index in 0..unsafe { bridge_symbol_count() } {
+        let mut stats = BridgeStats::default();
+        unsafe { bridge_stats_snapshot(index, &mut stats) };
+        if stats.calls == 0 {
+            continue;
+        }
+        let name = unsafe { CStr::from_ptr(bridge_symbol_name(index)) };
+        eprintln!(
+            "{:<24} {:>10} {:>14} {:>14} {:>12} {:>12} {:>12}",
+            name.to_string_lossy(),
+            stats.calls,
+            format!("{:?}", Duration::from_nanos(stats.marshal_ns / stats.calls)),
+            format!("{:?}", Duration::from_nanos(stats.native_ns / stats.calls)),
+            stats.bytes,
+            format!("{:?}", latency_quantile(&stats, 0.5)),
+            format!("{:?}", latency_quantile(&stats, 0.99)),
+        );
+    }
+}
+
+// ==== bridge provenance ==== //
+const BRIDGE_PROVENANCE_REPORT: c_int = 1;
+
+#[link(name = "my-helpers")]
+extern "C" {
+    fn bridge_provenance_enable(mode: c_int);
+    fn bridge_provenance_violations() -> libc::c_ulong;
+}
+
 // === //
 #[repr(C)]
 struct FuncPointer {
@@ -650,40 +914,421 @@ struct FuncPointer {
     add: i32,
 }
 
-#[link(name = "my-helpers")]
-extern "C" {   
-    fn modify_fp(fp: u32);
-}
+static MODIFY_FP: LazyNative = LazyNative::new("modify_fp\0");
 
 fn wrap_modify_fp(mut caller: Caller<'_, Host>, _fp: u32) {
+    let mut call = BridgeCall::enter(&MODIFY_FP);
     let linear_memory = caller.get_export("memory").unwrap().into_memory().unwrap().data_mut(&mut caller).as_mut_ptr();
     unsafe {
         let fp: *mut FuncPointer = linear_memory.add(_fp as usize).cast();
+        let modify_fp: unsafe extern "C" fn(u32) = mem::transmute(MODIFY_FP.get());
+        call.native();
         modify_fp(_fp)
     }
 }
 // === //
-#[link(name = "my-helpers")]
-extern "C" {   
-    fn modify(op: i32, new_name: i32) -> i32;
-}
+static MODIFY: LazyNative = LazyNative::new("modify\0");
 
 fn wrap_modify(mut caller: Caller<'_, Host>, op: i32, new_name: i32) -> i32 {
+    let mut call = BridgeCall::enter(&MODIFY);
     unsafe {
+        let modify: unsafe extern "C" fn(i32, i32) -> i32 = mem::transmute(MODIFY.get());
+        call.native();
         modify(op, new_name)
     }
 }
 // === //
-#[link(name = "my-helpers")]
-extern "C" {   
-    fn check_struct(c: i32);
-}
+static CHECK_STRUCT: LazyNative = LazyNative::new("check_struct\0");
 
 fn wrap_check_struct(mut caller: Caller<'_, Host>, c: i32){
+    let mut call = BridgeCall::enter(&CHECK_STRUCT);
     unsafe {
+        let check_struct: unsafe extern "C" fn(i32) = mem::transmute(CHECK_STRUCT.get());
+        call.native();
         check_struct(c)
     }
 }
+// === //
+static NEW_STU: LazyNative = LazyNative::new("new_stu\0");
+
+fn wrap_new_stu(mut caller: Caller<'_, Host>, ret: i32, name: i32, age: i32) -> Result<(), Trap> {
+    let mut call = BridgeCall::enter(&NEW_STU);
+    // The result is written straight into guest memory, which may have moved
+    // since the helpers last saw it.
+    if let Some(memory) = caller.get_export("memory").and_then(|e| e.into_memory()) {
+        unsafe { get_linear_memory(memory.data_mut(&mut caller).as_mut_ptr()) };
+    }
+    let status = unsafe {
+        let new_stu: unsafe extern "C" fn(i32, i32, i32) -> c_int = mem::transmute(NEW_STU.get());
+        call.native();
+        new_stu(ret, name, age)
+    };
+    if status != 0 {
+        return Err(Trap::new("new_stu: no memory for the struct result"));
+    }
+    Ok(())
+}
 
+#[cfg(test)]
+mod test {
+    use super::*;
+    use std::sync::Mutex;
+
+    /// `linear_memory` is a single global in the helpers, so tests that
+    /// point it somewhere take this first.
+    static LINEAR_MEMORY: Mutex<()> = Mutex::new(());
+
+    const BRIDGE_PROVENANCE_OFF: c_int = 0;
+    const BRIDGE_FIELD_SCALAR: c_int = 0;
+    const BRIDGE_FIELD_PTR: c_int = 1;
+
+    #[repr(C)]
+    #[derive(Clone, Copy)]
+    struct BridgeField {
+        kind: c_int,
+        guest_offset: u32,
+        host_offset: u32,
+        size: u32,
+    }
+
+    #[repr(C)]
+    struct BridgeLayout {
+        guest_size: u32,
+        host_size: u32,
+        nptrs: u32,
+        nruns: u32,
+        ptr_guest: [u32; 16],
+        ptr_host: [u32; 16],
+        runs: [BridgeField; 16],
+        identity: c_int,
+        to_host: *const c_void,
+        to_guest: *const c_void,
+    }
+
+    #[link(name = "my-helpers")]
+    extern "C" {
+        fn bridge_layout_init(
+            plan: *mut BridgeLayout,
+            fields: *const BridgeField,
+            nfields: c_int,
+            guest_size: u32,
+            host_size: u32,
+        ) -> c_int;
+        fn bridge_layout_to_host(
+            plan: *const BridgeLayout,
+            host: *mut c_void,
+            guest: *const c_void,
+            n: usize,
+        );
+        fn bridge_layout_to_guest(
+            plan: *const BridgeLayout,
+            guest: *mut c_void,
+            host: *const c_void,
+            n: usize,
+        );
+        fn bridge_store_guest_ptr(field: *mut c_void, value: c_int);
+        fn bridge_result_slot(plan: *const BridgeLayout, ret: c_int) -> *mut c_void;
+        fn bridge_result_commit(plan: *const BridgeLayout, ret: c_int, slot: *mut c_void);
+    }
+
+    fn layout(fields: &[BridgeField], guest_size: u32, host_size: u32) -> Option<BridgeLayout> {
+        let mut plan: BridgeLayout = unsafe { mem::zeroed() };
+        let ret = unsafe {
+            bridge_layout_init(
+                &mut plan,
+                fields.as_ptr(),
+                fields.len() as c_int,
+                guest_size,
+                host_size,
+            )
+        };
+        if ret == 0 {
+            Some(plan)
+        } else {
+            None
+        }
+    }
+
+    fn field(kind: c_int, guest_offset: u32, host_offset: u32, size: u32) -> BridgeField {
+        BridgeField {
+            kind,
+            guest_offset,
+            host_offset,
+            size,
+        }
+    }
 
+    fn symbol_names() -> Vec<String> {
+        (0..unsafe { bridge_symbol_count() })
+            .map(|i| {
+                unsafe { CStr::from_ptr(bridge_symbol_name(i)) }
+                    .to_string_lossy()
+                    .into_owned()
+            })
+            .collect()
+    }
+
+    #[test]
+    fn bridge_symbols_are_sorted() {
+        let names = symbol_names();
+        let mut sorted = names.clone();
+        sorted.sort();
+        assert_eq!(names, sorted);
+        assert!(unsafe { bridge_symbol_name(-1) }.is_null());
+        assert!(unsafe { bridge_symbol_name(names.len() as c_int) }.is_null());
+    }
 
+    #[test]
+    fn bridge_resolve_finds_every_symbol() {
+        for (i, name) in symbol_names().iter().enumerate() {
+            let cname = std::ffi::CString::new(name.as_str()).unwrap();
+            assert!(!unsafe { bridge_resolve(cname.as_ptr()) }.is_null());
+            assert_eq!(unsafe { bridge_symbol_index(cname.as_ptr()) }, i as c_int);
+        }
+        for (name, _) in BRIDGED_IMPORTS {
+            assert!(symbol_names().iter().any(|n| n == *name), "{}", name);
+        }
+    }
+
+    #[test]
+    fn bridge_resolve_unknown_symbol() {
+        for name in ["", "a", "modify_", "new_stv", "zzz\u{ff}"] {
+            let cname = std::ffi::CString::new(name).unwrap();
+            assert!(unsafe { bridge_resolve(cname.as_ptr()) }.is_null());
+            assert_eq!(unsafe { bridge_symbol_index(cname.as_ptr()) }, -1);
+        }
+    }
+
+    #[test]
+    fn lazy_native_caches_resolution() {
+        let native = LazyNative::new("modify\0");
+        assert!(native.slot.load(Ordering::Relaxed).is_null());
+        let first = native.get();
+        assert_eq!(native.slot.load(Ordering::Relaxed), first);
+        assert_eq!(native.get(), first);
+        assert_eq!(native.index(), unsafe {
+            bridge_symbol_index(b"modify\0".as_ptr().cast())
+        });
+    }
+
+    #[test]
+    #[should_panic(expected = "bridged native `not_linked` is not linked into this host")]
+    fn lazy_native_unresolved_symbol() {
+        LazyNative::new("not_linked\0").get();
+    }
+
+    #[test]
+    fn link_bridged_imports_only_known_env_imports() -> Result<()> {
+        let engine = Engine::default();
+        let mut store = Store::new(&engine, Host::default());
+        let mut linker = Linker::new(&engine);
+        let module = Module::new(
+            &engine,
+            r#"
+                (module
+                    (import "env" "modify" (func (param i32 i32) (result i32)))
+                    (import "env" "not_linked" (func))
+                    (import "other" "check_struct" (func (param i32))))
+            "#,
+        )?;
+        link_bridged_imports(&mut store, &mut linker, &module)?;
+        assert!(linker.get(&mut store, "env", "modify").is_some());
+        assert!(linker.get(&mut store, "env", "check_struct").is_none());
+        assert!(linker.get(&mut store, "env", "not_linked").is_none());
+        assert!(linker.get(&mut store, "other", "check_struct").is_none());
+
+        // Linking a second module importing the same native keeps the
+        // existing definition rather than failing on a duplicate.
+        link_bridged_imports(&mut store, &mut linker, &module)?;
+        Ok(())
+    }
+
+    #[test]
+    fn layout_rejects_bad_fields() {
+        // Unknown kind.
+        assert!(layout(&[field(7, 0, 0, 4)], 4, 4).is_none());
+        // Offsets that only fit if `offset + width` wraps around.
+        assert!(layout(&[field(BRIDGE_FIELD_PTR, u32::MAX - 1, 0, 0)], 8, 8).is_none());
+        assert!(layout(&[field(BRIDGE_FIELD_PTR, 0, u32::MAX - 1, 0)], 8, 8).is_none());
+        assert!(layout(&[field(BRIDGE_FIELD_SCALAR, 4, 4, u32::MAX)], 8, 8).is_none());
+        // Records too small for the field at all.
+        assert!(layout(&[field(BRIDGE_FIELD_PTR, 0, 0, 0)], 2, 8).is_none());
+        assert!(layout(&[field(BRIDGE_FIELD_PTR, 0, 0, 0)], 4, 4).is_none());
+        assert!(layout(&[field(BRIDGE_FIELD_SCALAR, 0, 0, 8)], 4, 8).is_none());
+        // Too many fields.
+        let many = [field(BRIDGE_FIELD_SCALAR, 0, 0, 1); 17];
+        assert!(layout(&many, 17, 17).is_none());
+
+        assert!(layout(&[field(BRIDGE_FIELD_PTR, 4, 8, 0)], 8, 16).is_some());
+        assert!(layout(&[field(BRIDGE_FIELD_SCALAR, 4, 4, 4)], 8, 8).is_some());
+    }
+
+    #[test]
+    fn layout_merges_runs_and_detects_identity() {
+        let plan = layout(
+            &[
+                field(BRIDGE_FIELD_SCALAR, 4, 4, 4),
+                field(BRIDGE_FIELD_SCALAR, 0, 0, 4),
+            ],
+            8,
+            8,
+        )
+        .unwrap();
+        assert_eq!(plan.nruns, 1);
+        assert_eq!(plan.runs[0].size, 8);
+        assert_ne!(plan.identity, 0);
+
+        let plan = layout(
+            &[
+                field(BRIDGE_FIELD_SCALAR, 0, 0, 4),
+                field(BRIDGE_FIELD_SCALAR, 4, 8, 4),
+            ],
+            8,
+            12,
+        )
+        .unwrap();
+        assert_eq!(plan.nruns, 2);
+        assert_eq!(plan.identity, 0);
+    }
+
+    #[repr(C)]
+    #[derive(Clone, Copy, Debug, PartialEq)]
+    struct HostStu {
+        name: *mut u8,
+        age: i32,
+    }
+
+    #[test]
+    fn layout_round_trip() {
+        let _guard = LINEAR_MEMORY.lock().unwrap();
+        let plan = layout(
+            &[
+                field(BRIDGE_FIELD_PTR, 0, 0, 0),
+                field(BRIDGE_FIELD_SCALAR, 4, mem::size_of::<usize>() as u32, 4),
+            ],
+            8,
+            mem::size_of::<HostStu>() as u32,
+        )
+        .unwrap();
+        let mut memory = vec![0u8; 4096];
+        unsafe { get_linear_memory(memory.as_mut_ptr()) };
+        let base = memory.as_mut_ptr();
+
+        // Covers an empty batch, the vector blocks and their scalar tails.
+        for n in 0..10usize {
+            let mut guest = vec![0u8; n * 8];
+            for i in 0..n {
+                let name = if i == 3 { 0 } else { 100 + i as u32 };
+                guest[i * 8..][..4].copy_from_slice(&name.to_le_bytes());
+                guest[i * 8 + 4..][..4].copy_from_slice(&(i as i32 * 7).to_le_bytes());
+            }
+            let mut host = vec![
+                HostStu {
+                    name: ptr::null_mut(),
+                    age: -1,
+                };
+                n
+            ];
+            unsafe {
+                bridge_layout_to_host(&plan, host.as_mut_ptr().cast(), guest.as_ptr().cast(), n)
+            };
+            for (i, stu) in host.iter().enumerate() {
+                let name = if i == 3 { 0 } else { 100 + i };
+                assert_eq!(stu.name, unsafe { base.add(name) });
+                assert_eq!(stu.age, i as i32 * 7);
+            }
+
+            if n > 1 {
+                // A NULL host pointer goes back as the guest's NULL.
+                host[1].name = ptr::null_mut();
+            }
+            let mut back = vec![0xffu8; n * 8];
+            unsafe {
+                bridge_layout_to_guest(&plan, back.as_mut_ptr().cast(), host.as_ptr().cast(), n)
+            };
+            if n > 1 {
+                guest[8..12].copy_from_slice(&0u32.to_le_bytes());
+            }
+            assert_eq!(back, guest, "{} records", n);
+        }
+    }
+
+    #[test]
+    fn layout_to_host_tags_offsets_under_provenance() {
+        let _guard = LINEAR_MEMORY.lock().unwrap();
+        let plan = layout(&[field(BRIDGE_FIELD_PTR, 0, 0, 0)], 4, 8).unwrap();
+        let mut memory = vec![0u8; 4096];
+        unsafe { get_linear_memory(memory.as_mut_ptr()) };
+
+        // Enough records for the vector paths, at offsets no other test
+        // tags.
+        let n = 32;
+        let guest = (0..n)
+            .flat_map(|i| (3000 + 4 * i as u32).to_le_bytes())
+            .collect::<Vec<_>>();
+        let mut host = vec![ptr::null_mut::<u8>(); n];
+        let mut slot = 0i32;
+        unsafe {
+            bridge_provenance_enable(BRIDGE_PROVENANCE_REPORT);
+            let before = bridge_provenance_violations();
+            bridge_layout_to_host(&plan, host.as_mut_ptr().cast(), guest.as_ptr().cast(), n);
+            for i in 0..n {
+                bridge_store_guest_ptr((&mut slot as *mut i32).cast(), 3000 + 4 * i as c_int);
+            }
+            let after = bridge_provenance_violations();
+            // An offset that never came from the guest is still reported.
+            bridge_store_guest_ptr((&mut slot as *mut i32).cast(), 3002);
+            let untagged = bridge_provenance_violations();
+            bridge_provenance_enable(BRIDGE_PROVENANCE_OFF);
+            assert_eq!(after, before);
+            assert_eq!(untagged, after + 1);
+        }
+    }
+
+    #[test]
+    fn identity_result_is_built_in_place() {
+        let _guard = LINEAR_MEMORY.lock().unwrap();
+        let plan = layout(
+            &[
+                field(BRIDGE_FIELD_SCALAR, 0, 0, 4),
+                field(BRIDGE_FIELD_SCALAR, 4, 4, 4),
+            ],
+            8,
+            8,
+        )
+        .unwrap();
+        assert_ne!(plan.identity, 0);
+        let mut memory = vec![0u8; 4096];
+        unsafe { get_linear_memory(memory.as_mut_ptr()) };
+        let base = memory.as_mut_ptr();
+
+        // The slot is the guest record itself and committing copies nothing.
+        let slot = unsafe { bridge_result_slot(&plan, 64) };
+        assert_eq!(slot.cast::<u8>(), unsafe { base.add(64) });
+        unsafe {
+            let record = slot.cast::<u8>();
+            ptr::copy_nonoverlapping(200u32.to_le_bytes().as_ptr(), record, 4);
+            ptr::copy_nonoverlapping(21i32.to_le_bytes().as_ptr(), record.add(4), 4);
+            bridge_result_commit(&plan, 64, slot);
+        }
+        assert_eq!(memory[64..68], 200u32.to_le_bytes());
+        assert_eq!(memory[68..72], 21i32.to_le_bytes());
+        assert!(memory[..64].iter().all(|b| *b == 0));
+        assert!(memory[72..].iter().all(|b| *b == 0));
+    }
+
+    #[test]
+    fn new_stu_fills_guest_result() {
+        let _guard = LINEAR_MEMORY.lock().unwrap();
+        let mut memory = vec![0u8; 4096];
+        unsafe { get_linear_memory(memory.as_mut_ptr()) };
+        let new_stu: unsafe extern "C" fn(i32, i32, i32) -> c_int =
+            unsafe { mem::transmute(NEW_STU.get()) };
+        assert_eq!(unsafe { new_stu(64, 200, 21) }, 0);
+        assert_eq!(memory[64..68], 200u32.to_le_bytes());
+        assert_eq!(memory[68..72], 21i32.to_le_bytes());
+        // Nothing outside the 8-byte guest record is touched.
+        assert!(memory[..64].iter().all(|b| *b == 0));
+        assert!(memory[72..].iter().all(|b| *b == 0));
+    }
+}
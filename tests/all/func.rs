@@ -524,6 +524,22 @@ fn pass_cross_store_arg() -> anyhow::Result<()> {
     Ok(())
 }
 
+#[test]
+fn belongs_to() -> anyhow::Result<()> {
+    let engine = Engine::default();
+    let mut store1 = Store::new(&engine, ());
+    let mut store2 = Store::new(&engine, ());
+
+    let store1_func = Func::wrap(&mut store1, || {});
+    let store2_func = Func::wrap(&mut store2, || {});
+
+    assert!(store1_func.belongs_to(&store1));
+    assert!(!store1_func.belongs_to(&store2));
+    assert!(store2_func.belongs_to(&store2));
+    assert!(!store2_func.belongs_to(&store1));
+    Ok(())
+}
+
 #[test]
 fn externref_signature_no_reference_types() -> anyhow::Result<()> {
     let mut config = Config::new();
@@ -487,3 +487,115 @@ fn no_gc_middle_of_args() -> anyhow::Result<()> {
 
     Ok(())
 }
+
+struct CountDrops(Arc<AtomicUsize>);
+
+impl Drop for CountDrops {
+    fn drop(&mut self) {
+        self.0.fetch_add(1, SeqCst);
+    }
+}
+
+/// Returns a store and a `take` function which hands its `externref` argument
+/// to Wasm and drops it.
+fn take_externref_store() -> anyhow::Result<(Store<()>, Func)> {
+    let (mut store, module) = ref_types_module(
+        false,
+        r#"
+            (module
+                (func (export "take") (param externref))
+            )
+        "#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let take = instance.get_func(&mut store, "take").unwrap();
+    Ok((store, take))
+}
+
+/// Passes `n` fresh `externref`s to `take`, returning a count of how many of
+/// them have been dropped.
+fn take_externrefs(
+    store: &mut Store<()>,
+    take: Func,
+    n: usize,
+) -> anyhow::Result<Arc<AtomicUsize>> {
+    let drops = Arc::new(AtomicUsize::new(0));
+    for _ in 0..n {
+        let r = ExternRef::new(CountDrops(drops.clone()));
+        take.call(&mut *store, &[Val::ExternRef(Some(r))], &mut [])?;
+    }
+    Ok(drops)
+}
+
+#[test]
+fn budgeted_gc_leaves_refs_pending() -> anyhow::Result<()> {
+    let (mut store, take) = take_externref_store()?;
+    store.set_gc_release_budget(Some(0));
+    let drops = take_externrefs(&mut store, take, 10)?;
+
+    store.gc();
+    assert_eq!(drops.load(SeqCst), 0);
+    assert_eq!(store.gc_stats().refs_pending, 10);
+
+    // Later steps drain what the budgeted collection left behind.
+    let step = store.gc_step(4, None);
+    assert_eq!(step.refs_released, 4);
+    assert_eq!(step.refs_pending, 6);
+    assert_eq!(drops.load(SeqCst), 4);
+
+    let step = store.gc_step(usize::MAX, None);
+    assert_eq!(step.refs_released, 6);
+    assert_eq!(step.refs_pending, 0);
+    assert_eq!(drops.load(SeqCst), 10);
+    Ok(())
+}
+
+#[test]
+fn gc_step_stops_at_deadline() -> anyhow::Result<()> {
+    let (mut store, take) = take_externref_store()?;
+    let drops = take_externrefs(&mut store, take, 10)?;
+
+    let step = store.gc_step(usize::MAX, Some(std::time::Duration::ZERO));
+    assert_eq!(step.collections, 1);
+    assert_eq!(step.refs_released, 0);
+    assert_eq!(step.refs_pending, 10);
+    assert_eq!(drops.load(SeqCst), 0);
+
+    store.gc();
+    assert_eq!(drops.load(SeqCst), 10);
+    Ok(())
+}
+
+#[test]
+fn set_gc_trigger_takes_effect_at_next_gc() -> anyhow::Result<()> {
+    let (mut store, take) = take_externref_store()?;
+    store.gc();
+    store.set_gc_trigger(1024);
+
+    // The default-sized buffer is still in use until the next collection.
+    let collections = store.gc_stats().collections;
+    take_externrefs(&mut store, take, 600)?;
+    assert!(store.gc_stats().collections > collections);
+
+    // After it, 600 references fit without triggering a collection.
+    store.gc();
+    let collections = store.gc_stats().collections;
+    take_externrefs(&mut store, take, 600)?;
+    assert_eq!(store.gc_stats().collections, collections);
+    take_externrefs(&mut store, take, 600)?;
+    assert!(store.gc_stats().collections > collections);
+    Ok(())
+}
+
+#[test]
+fn default_gc_releases_everything() -> anyhow::Result<()> {
+    let (mut store, take) = take_externref_store()?;
+    let drops = take_externrefs(&mut store, take, 2000)?;
+
+    // `wasmtime_context_gc` is `Store::gc` with the default, unlimited,
+    // release budget.
+    store.gc();
+    assert_eq!(drops.load(SeqCst), 2000);
+    assert_eq!(store.gc_stats().refs_pending, 0);
+    Ok(())
+}
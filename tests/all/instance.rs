@@ -80,3 +80,213 @@ fn linear_memory_limits() -> Result<()> {
         Ok(())
     }
 }
+
+#[test]
+fn reset_restores_grown_memory() -> Result<()> {
+    for cow in [true, false] {
+        let mut config = Config::new();
+        config.memory_init_cow(cow);
+        let engine = Engine::new(&config)?;
+        let module = Module::new(
+            &engine,
+            r#"
+                (module
+                    (memory (export "memory") 1)
+                    (data (i32.const 0) "hello")
+                )
+            "#,
+        )?;
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let memory = instance.get_memory(&mut store, "memory").unwrap();
+
+        memory.write(&mut store, 0, b"HELLO")?;
+        memory.write(&mut store, 100, &[1])?;
+        memory.grow(&mut store, 2)?;
+        memory.write(&mut store, 2 * 65536, &[2])?;
+
+        instance.reset(&mut store)?;
+        assert_eq!(memory.size(&store), 1);
+        let mut bytes = [0; 5];
+        memory.read(&store, 0, &mut bytes)?;
+        assert_eq!(&bytes, b"hello");
+        assert_eq!(memory.data(&store)[100], 0);
+
+        // The pages given up by the reset come back zeroed.
+        memory.grow(&mut store, 2)?;
+        assert_eq!(memory.data(&store)[2 * 65536], 0);
+    }
+    Ok(())
+}
+
+#[test]
+fn reset_restores_grown_table() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let module = Module::new(
+        store.engine(),
+        r#"
+            (module
+                (table (export "table") 1 funcref)
+                (elem (i32.const 0) $f)
+                (func $f)
+            )
+        "#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let table = instance.get_table(&mut store, "table").unwrap();
+    let f = table.get(&mut store, 0).unwrap();
+
+    table.grow(&mut store, 3, f)?;
+    table.set(&mut store, 0, Val::FuncRef(None))?;
+
+    instance.reset(&mut store)?;
+    assert_eq!(table.size(&store), 1);
+    assert!(table.get(&mut store, 0).unwrap().unwrap_funcref().is_some());
+    Ok(())
+}
+
+#[test]
+fn reset_releases_externref_globals() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let module = Module::new(
+        store.engine(),
+        r#"
+            (module
+                (global (export "g") (mut externref) (ref.null extern))
+            )
+        "#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let global = instance.get_global(&mut store, "g").unwrap();
+
+    let r = ExternRef::new("hello");
+    global.set(&mut store, Val::ExternRef(Some(r.clone())))?;
+    assert!(r.strong_count() > 1);
+
+    instance.reset(&mut store)?;
+    store.gc();
+    assert!(global.get(&mut store).unwrap_externref().is_none());
+    assert_eq!(r.strong_count(), 1);
+    Ok(())
+}
+
+#[test]
+fn reset_restores_dropped_segments() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let module = Module::new(
+        store.engine(),
+        r#"
+            (module
+                (memory 1)
+                (table 1 funcref)
+                (data $d "abc")
+                (elem $e func $f)
+                (func $f)
+                (func (export "init")
+                    (memory.init $d (i32.const 0) (i32.const 0) (i32.const 3))
+                    (table.init $e (i32.const 0) (i32.const 0) (i32.const 1)))
+                (func (export "drop")
+                    data.drop $d
+                    elem.drop $e)
+            )
+        "#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let init = instance.get_typed_func::<(), (), _>(&mut store, "init")?;
+    let drop_segments = instance.get_typed_func::<(), (), _>(&mut store, "drop")?;
+
+    init.call(&mut store, ())?;
+    drop_segments.call(&mut store, ())?;
+    assert!(init.call(&mut store, ()).is_err());
+
+    instance.reset(&mut store)?;
+    init.call(&mut store, ())?;
+    Ok(())
+}
+
+#[test]
+fn reset_reruns_start() -> Result<()> {
+    let mut store = Store::new(&Engine::default(), 0);
+    let module = Module::new(
+        store.engine(),
+        r#"
+            (module
+                (import "" "started" (func $started))
+                (global (export "g") (mut i32) (i32.const 0))
+                (func $start
+                    call $started
+                    (global.set 0 (i32.add (global.get 0) (i32.const 1))))
+                (start $start)
+            )
+        "#,
+    )?;
+    let started = Func::wrap(&mut store, |mut caller: Caller<'_, i32>| {
+        *caller.data_mut() += 1;
+    });
+    let instance = Instance::new(&mut store, &module, &[started.into()])?;
+    let global = instance.get_global(&mut store, "g").unwrap();
+    assert_eq!(*store.data(), 1);
+    assert_eq!(global.get(&mut store).unwrap_i32(), 1);
+
+    global.set(&mut store, Val::I32(10))?;
+    instance.reset(&mut store)?;
+    assert_eq!(*store.data(), 2);
+    assert_eq!(global.get(&mut store).unwrap_i32(), 1);
+    Ok(())
+}
+
+#[test]
+fn reset_leaves_imports_alone() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let memory = Memory::new(&mut store, MemoryType::new(1, None))?;
+    let module = Module::new(
+        store.engine(),
+        r#"
+            (module
+                (import "" "memory" (memory 1))
+                (data (i32.const 0) "hello")
+            )
+        "#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[memory.into()])?;
+    memory.write(&mut store, 0, b"HELLO")?;
+    memory.grow(&mut store, 1)?;
+
+    instance.reset(&mut store)?;
+    assert_eq!(memory.size(&store), 2);
+    let mut bytes = [0; 5];
+    memory.read(&store, 0, &mut bytes)?;
+    assert_eq!(&bytes, b"HELLO");
+    Ok(())
+}
+
+#[test]
+fn reset_while_executing() -> Result<()> {
+    let mut store = Store::new(&Engine::default(), None);
+    let module = Module::new(
+        store.engine(),
+        r#"
+            (module
+                (import "" "reset" (func $reset))
+                (func (export "run") call $reset)
+            )
+        "#,
+    )?;
+    let reset = Func::wrap(&mut store, |mut caller: Caller<'_, Option<Instance>>| {
+        let instance = caller.data().unwrap();
+        let err = instance.reset(&mut caller).unwrap_err();
+        assert!(
+            err.to_string().contains("WebAssembly is executing"),
+            "bad error: {}",
+            err
+        );
+    });
+    let instance = Instance::new(&mut store, &module, &[reset.into()])?;
+    *store.data_mut() = Some(instance);
+    let run = instance.get_typed_func::<(), (), _>(&mut store, "run")?;
+    run.call(&mut store, ())?;
+
+    // Once the call has returned the instance can be reset.
+    instance.reset(&mut store)?;
+    Ok(())
+}
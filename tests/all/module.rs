@@ -168,3 +168,27 @@ fn serialize_not_overly_massive() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+fn uses_copy_on_write_image() -> Result<()> {
+    let engine = Engine::default();
+    let uses = |wat: &str| Module::new(&engine, wat)?.uses_copy_on_write_image();
+
+    assert!(!uses("(module)")?);
+    assert!(!uses("(module (memory 1))")?);
+    assert!(!uses(
+        r#"(module (import "" "" (memory 1)) (data (i32.const 0) "a"))"#
+    )?);
+
+    // Images are only created from in-memory modules on Linux.
+    if cfg!(target_os = "linux") {
+        assert!(uses(r#"(module (memory 1) (data (i32.const 0) "a"))"#)?);
+    }
+
+    let mut config = Config::new();
+    config.memory_init_cow(false);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(&engine, r#"(module (memory 1) (data (i32.const 0) "a"))"#)?;
+    assert!(!module.uses_copy_on_write_image()?);
+    Ok(())
+}
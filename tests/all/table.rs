@@ -1,4 +1,6 @@
 use anyhow::Result;
+use std::sync::atomic::{AtomicUsize, Ordering::SeqCst};
+use std::sync::Arc;
 use wasmtime::*;
 
 #[test]
@@ -75,3 +77,250 @@ fn null_elem_segment_works_with_imported_table() -> Result<()> {
     Instance::new(&mut store, &module, &[table.into()])?;
     Ok(())
 }
+
+struct CountDrops(Arc<AtomicUsize>);
+
+impl Drop for CountDrops {
+    fn drop(&mut self) {
+        self.0.fetch_add(1, SeqCst);
+    }
+}
+
+fn externref_table(store: &mut Store<()>, size: u32) -> Result<Table> {
+    let ty = TableType::new(ValType::ExternRef, size, None);
+    Table::new(store, ty, Val::ExternRef(None))
+}
+
+fn externref(drops: &Arc<AtomicUsize>) -> ExternRef {
+    ExternRef::new(CountDrops(drops.clone()))
+}
+
+fn some(r: &ExternRef) -> Val {
+    Val::ExternRef(Some(r.clone()))
+}
+
+/// Asserts that `table[index..]` holds exactly the references in `expected`.
+fn assert_externrefs(
+    store: &mut Store<()>,
+    table: &Table,
+    index: u32,
+    expected: &[Option<&ExternRef>],
+) -> Result<()> {
+    let mut out = vec![None; expected.len()];
+    table.get_externrefs(&mut *store, index, &mut out)?;
+    for (actual, expected) in out.iter().zip(expected) {
+        match (actual, expected) {
+            (None, None) => {}
+            (Some(a), Some(b)) => assert!(a.ptr_eq(b)),
+            _ => panic!("expected {:?}, found {:?}", expected, actual),
+        }
+    }
+    Ok(())
+}
+
+#[test]
+fn fill_externref_over_same_ref() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let drops = Arc::new(AtomicUsize::new(0));
+    let table = externref_table(&mut store, 8)?;
+    let r = externref(&drops);
+
+    table.fill(&mut store, 0, some(&r), 8)?;
+    assert_eq!(r.strong_count(), 9);
+
+    // Overwriting a range that already holds `r` with `r` leaves its count
+    // alone.
+    table.fill(&mut store, 2, some(&r), 4)?;
+    assert_eq!(r.strong_count(), 9);
+
+    table.fill(&mut store, 0, Val::ExternRef(None), 8)?;
+    assert_eq!(r.strong_count(), 1);
+    assert_eq!(drops.load(SeqCst), 0);
+    drop(r);
+    assert_eq!(drops.load(SeqCst), 1);
+    Ok(())
+}
+
+#[test]
+fn fill_externref_len_zero() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let drops = Arc::new(AtomicUsize::new(0));
+    let table = externref_table(&mut store, 4)?;
+    let r = externref(&drops);
+
+    table.fill(&mut store, 1, some(&r), 0)?;
+    table.fill(&mut store, 4, some(&r), 0)?;
+    assert_eq!(r.strong_count(), 1);
+    assert_externrefs(&mut store, &table, 0, &[None; 4])?;
+    drop(r);
+    assert_eq!(drops.load(SeqCst), 1);
+    Ok(())
+}
+
+#[test]
+fn copy_externrefs_within_overlapping() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let drops = Arc::new(AtomicUsize::new(0));
+    let table = externref_table(&mut store, 8)?;
+    let a = externref(&drops);
+    let b = externref(&drops);
+    table.fill(&mut store, 0, some(&a), 3)?;
+    table.fill(&mut store, 3, some(&b), 2)?;
+
+    // Copy forwards over an overlapping range: [a a a b b - - -] becomes
+    // [a a a a a b b -].
+    Table::copy(&mut store, &table, 2, &table, 0, 5)?;
+    let (a_, b_) = (Some(&a), Some(&b));
+    assert_externrefs(&mut store, &table, 0, &[a_, a_, a_, a_, a_, b_, b_, None])?;
+    assert_eq!(a.strong_count(), 6);
+    assert_eq!(b.strong_count(), 3);
+
+    // And backwards: [a a a a a b b -] becomes [a a a b b b b -].
+    Table::copy(&mut store, &table, 0, &table, 2, 5)?;
+    assert_externrefs(&mut store, &table, 0, &[a_, a_, a_, b_, b_, b_, b_, None])?;
+    assert_eq!(a.strong_count(), 4);
+    assert_eq!(b.strong_count(), 5);
+
+    table.fill(&mut store, 0, Val::ExternRef(None), 8)?;
+    assert_eq!(a.strong_count(), 1);
+    assert_eq!(b.strong_count(), 1);
+    drop((a, b));
+    assert_eq!(drops.load(SeqCst), 2);
+    Ok(())
+}
+
+#[test]
+fn copy_externrefs_between_tables() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let drops = Arc::new(AtomicUsize::new(0));
+    let src = externref_table(&mut store, 4)?;
+    let dst = externref_table(&mut store, 4)?;
+    let a = externref(&drops);
+    let b = externref(&drops);
+    let c = externref(&drops);
+    src.fill(&mut store, 0, some(&a), 2)?;
+    src.fill(&mut store, 2, some(&b), 2)?;
+    dst.fill(&mut store, 0, some(&c), 4)?;
+
+    Table::copy(&mut store, &dst, 0, &src, 1, 3)?;
+    let (a_, b_, c_) = (Some(&a), Some(&b), Some(&c));
+    assert_externrefs(&mut store, &dst, 0, &[a_, b_, b_, c_])?;
+    assert_externrefs(&mut store, &src, 0, &[a_, a_, b_, b_])?;
+    assert_eq!(a.strong_count(), 4);
+    assert_eq!(b.strong_count(), 5);
+    assert_eq!(c.strong_count(), 2);
+
+    drop(store);
+    assert_eq!(a.strong_count(), 1);
+    assert_eq!(b.strong_count(), 1);
+    assert_eq!(c.strong_count(), 1);
+    drop((a, b, c));
+    assert_eq!(drops.load(SeqCst), 3);
+    Ok(())
+}
+
+#[test]
+fn get_set_externrefs_round_trip() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let drops = Arc::new(AtomicUsize::new(0));
+    let table = externref_table(&mut store, 6)?;
+    let a = externref(&drops);
+    let b = externref(&drops);
+
+    // Moving references in leaves `None` behind without touching counts.
+    let mut vals = vec![Some(a.clone()), Some(a.clone()), None, Some(b.clone())];
+    table.set_externrefs(&mut store, 1, &mut vals)?;
+    assert!(vals.iter().all(|v| v.is_none()));
+    assert_eq!(a.strong_count(), 3);
+    assert_eq!(b.strong_count(), 2);
+
+    let mut out = vec![None; 6];
+    table.get_externrefs(&mut store, 0, &mut out)?;
+    let (a_, b_) = (Some(&a), Some(&b));
+    for (actual, expected) in out.iter().zip([None, a_, a_, None, b_, None]) {
+        assert_eq!(actual.is_some(), expected.is_some());
+        if let (Some(x), Some(y)) = (actual, expected) {
+            assert!(x.ptr_eq(y));
+        }
+    }
+    assert_eq!(a.strong_count(), 5);
+    assert_eq!(b.strong_count(), 3);
+
+    // Reading again over `out` releases what it held before.
+    table.get_externrefs(&mut store, 0, &mut out)?;
+    assert_eq!(a.strong_count(), 5);
+    assert_eq!(b.strong_count(), 3);
+    drop(out);
+    assert_eq!(a.strong_count(), 3);
+    assert_eq!(b.strong_count(), 2);
+
+    // Overwriting releases the references the table held.
+    table.set_externrefs(&mut store, 0, &mut vec![None; 6])?;
+    assert_eq!(a.strong_count(), 1);
+    assert_eq!(b.strong_count(), 1);
+    drop((a, b));
+    assert_eq!(drops.load(SeqCst), 2);
+    Ok(())
+}
+
+#[test]
+fn get_set_externrefs_out_of_bounds() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let drops = Arc::new(AtomicUsize::new(0));
+    let table = externref_table(&mut store, 4)?;
+    let a = externref(&drops);
+    let b = externref(&drops);
+    table.fill(&mut store, 0, some(&a), 4)?;
+
+    let mut out = vec![Some(b.clone()), None];
+    assert!(table.get_externrefs(&mut store, 3, &mut out).is_err());
+    assert!(table
+        .get_externrefs(&mut store, u32::MAX, &mut out)
+        .is_err());
+    assert!(out[0].as_ref().unwrap().ptr_eq(&b));
+    assert!(out[1].is_none());
+    assert_eq!(a.strong_count(), 5);
+    assert_eq!(b.strong_count(), 2);
+
+    let mut vals = vec![Some(b.clone()), None];
+    assert!(table.set_externrefs(&mut store, 3, &mut vals).is_err());
+    assert!(table
+        .set_externrefs(&mut store, u32::MAX, &mut vals)
+        .is_err());
+    assert!(vals[0].as_ref().unwrap().ptr_eq(&b));
+    assert!(vals[1].is_none());
+    assert_eq!(a.strong_count(), 5);
+    assert_eq!(b.strong_count(), 3);
+
+    drop((out, vals, store));
+    drop((a, b));
+    assert_eq!(drops.load(SeqCst), 2);
+    Ok(())
+}
+
+#[test]
+fn get_set_externrefs_on_funcref_table() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let ty = TableType::new(ValType::FuncRef, 2, None);
+    let table = Table::new(&mut store, ty, Val::FuncRef(None))?;
+    let drops = Arc::new(AtomicUsize::new(0));
+    let a = externref(&drops);
+
+    let mut out = vec![Some(a.clone())];
+    let err = table.get_externrefs(&mut store, 0, &mut out).unwrap_err();
+    assert_eq!(
+        err.to_string(),
+        "table does not contain `externref` elements"
+    );
+    assert!(out[0].as_ref().unwrap().ptr_eq(&a));
+
+    let mut vals = vec![Some(a.clone())];
+    let err = table.set_externrefs(&mut store, 0, &mut vals).unwrap_err();
+    assert_eq!(
+        err.to_string(),
+        "table does not contain `externref` elements"
+    );
+    assert!(vals[0].as_ref().unwrap().ptr_eq(&a));
+    assert_eq!(a.strong_count(), 3);
+    Ok(())
+}
@@ -1058,3 +1058,111 @@ async fn sync_then_async_trap() -> Result<()> {
 
     Ok(())
 }
+
+/// Runs a module which traps three calls deep with `config`, returning the
+/// trap.
+fn trap_with_config(config: &Config) -> Result<Trap> {
+    let engine = Engine::new(config)?;
+    let mut store = Store::new(&engine, ());
+    let wat = r#"
+        (module $lazy_mod
+            (func (export "run") (call $a))
+            (func $a (call $b))
+            (func $b (unreachable))
+        )
+    "#;
+    let module = Module::new(&engine, wat)?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let run_func = instance.get_typed_func::<(), (), _>(&mut store, "run")?;
+    Ok(run_func
+        .call(&mut store, ())
+        .err()
+        .expect("error calling function"))
+}
+
+/// Function index, module name, function name, function offset and module
+/// offset of a frame.
+type FrameSummary = (
+    u32,
+    Option<String>,
+    Option<String>,
+    Option<usize>,
+    Option<usize>,
+);
+
+fn frame_summary(trace: &[FrameInfo]) -> Vec<FrameSummary> {
+    trace
+        .iter()
+        .map(|frame| {
+            (
+                frame.func_index(),
+                frame.module_name().map(String::from),
+                frame.func_name().map(String::from),
+                frame.func_offset(),
+                frame.module_offset(),
+            )
+        })
+        .collect()
+}
+
+#[test]
+fn lazy_backtrace_matches_eager() -> Result<()> {
+    let eager = trap_with_config(&Config::new())?;
+    let lazy = trap_with_config(Config::new().wasm_backtrace_lazy(true))?;
+
+    let eager_trace = frame_summary(eager.trace().expect("backtrace is available"));
+    assert_eq!(eager_trace.len(), 3);
+    assert_eq!(eager_trace[0].0, 2);
+    assert_eq!(eager_trace[0].1.as_deref(), Some("lazy_mod"));
+    assert_eq!(eager_trace[0].2.as_deref(), Some("b"));
+
+    let lazy_trace = frame_summary(lazy.trace().expect("backtrace is available"));
+    assert_eq!(lazy_trace, eager_trace);
+    // The symbolized frames are cached after the first request.
+    assert_eq!(frame_summary(lazy.trace().unwrap()), eager_trace);
+    assert_eq!(lazy.to_string(), eager.to_string());
+    Ok(())
+}
+
+#[test]
+fn disabled_backtrace_has_no_trace() -> Result<()> {
+    let trap = trap_with_config(Config::new().wasm_backtrace(false))?;
+    assert!(trap.trace().is_none());
+    assert_eq!(trap.trap_code(), Some(TrapCode::UnreachableCodeReached));
+
+    let trap = trap_with_config(
+        Config::new()
+            .wasm_backtrace(false)
+            .wasm_backtrace_lazy(true),
+    )?;
+    assert!(trap.trace().is_none());
+    Ok(())
+}
+
+#[test]
+fn exit_trap_has_no_trace() -> Result<()> {
+    for lazy in [false, true] {
+        let engine = Engine::new(Config::new().wasm_backtrace_lazy(lazy))?;
+        let mut store = Store::new(&engine, ());
+        let wat = r#"
+            (module
+                (import "" "exit" (func $exit))
+                (func (export "run") (call $exit))
+            )
+        "#;
+        let module = Module::new(&engine, wat)?;
+        let exit = Func::wrap(&mut store, || -> Result<(), Trap> {
+            Err(Trap::i32_exit(3))
+        });
+        let instance = Instance::new(&mut store, &module, &[exit.into()])?;
+        let run_func = instance.get_typed_func::<(), (), _>(&mut store, "run")?;
+
+        let trap = run_func
+            .call(&mut store, ())
+            .err()
+            .expect("error calling function");
+        assert_eq!(trap.i32_exit_status(), Some(3));
+        assert!(trap.trace().is_none());
+    }
+    Ok(())
+}